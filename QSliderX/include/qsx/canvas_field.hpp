@@ -2,14 +2,28 @@
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
 #pragma once
+#include <functional>
+
 #include <QImage>
+#include <QPainter>
 #include <QWidget>
 
+#include "qsx/internal/field_stats.hpp"
 #include "qsx/internal/float_field.hpp"
+#include "qsx/slider_range.hpp" // PairVec
 
 namespace qsx
 {
 
+enum SymmetryMode : int
+{
+  NO_SYMMETRY, ///< No symmetry
+  MIRROR_X,    ///< Mirror with respect to the vertical center axis
+  MIRROR_Y,    ///< Mirror with respect to the horizontal center axis
+  MIRROR_XY,   ///< Mirror with respect to both center axes
+  RADIAL,      ///< N-fold rotational symmetry around the field center
+};
+
 class CanvasField : public QWidget
 {
   Q_OBJECT
@@ -22,15 +36,35 @@ public:
               int                field_height = 256,
               QWidget           *parent = nullptr);
 
-  void               clear();
-  std::vector<float> get_field_data() const;
-  std::vector<float> get_field_angle_data() const;
-  int                get_field_height() const;
-  int                get_field_width() const;
-  void               set_allow_angle_mode(bool new_state);
-  void               set_bg_image(const QImage &new_bg_image);
-  void               set_brush_strength(float new_strength);
-  void               set_field_data(const std::vector<float> &new_data);
+  void                     clear();
+  std::vector<float>       get_field_data() const;
+  std::vector<float>       get_field_angle_data() const;
+  int                      get_field_height() const;
+  PairVec                  get_field_histogram() const;
+  float                    get_field_max() const;
+  float                    get_field_mean() const;
+  float                    get_field_min() const;
+  int                      get_field_width() const;
+  std::function<PairVec()> get_histogram_fct();
+  SymmetryMode             get_symmetry_mode() const;
+  void                     set_allow_angle_mode(bool new_state);
+  void                     set_bg_image(const QImage &new_bg_image);
+  void                     set_brush_strength(float new_strength);
+  void                     set_field_data(const std::vector<float> &new_data);
+  void                     set_field_size(int            new_width,
+                                          int            new_height,
+                                          ResampleFilter filter = ResampleFilter::BILINEAR);
+  void                     set_radial_symmetry_order(int new_order);
+  void                     set_symmetry_mode(SymmetryMode new_mode);
+
+  // fill tools, positions are given in field cell coordinates, emit a single
+  // 'edit_ended' and return the modified region
+  QRect flood_fill(int   x,
+                   int   y,
+                   float value,
+                   float tolerance = 0.f,
+                   bool  connectivity8 = false);
+  QRect lasso_fill(const std::vector<QPointF> &polygon, float value);
 
   QSize sizeHint() const override;
 
@@ -50,15 +84,34 @@ protected:
   void wheelEvent(QWheelEvent *event) override;
 
 private:
-  QColor colormap(float v) const;
-  void   draw_at(const Qt::MouseButtons &buttons);
-  void   draw_at(const QPoint &pos, const Qt::MouseButtons &buttons);
-  bool   is_mouse_cursor_on_img() const;
-  void   update_geometry();
+  enum class Tool
+  {
+    BRUSH,
+    FLOOD_FILL,
+    LASSO_FILL,
+  };
+
+  // brush footprint center and stroke direction (angle in [0, 1])
+  struct Stamp
+  {
+    int   x;
+    int   y;
+    float angle;
+  };
+
+  QRect              apply_stamps(const std::vector<Stamp> &stamps, float sign);
+  QColor             colormap(float v) const;
+  void               draw_at(const Qt::MouseButtons &buttons);
+  void               draw_at(const QPoint &pos, const Qt::MouseButtons &buttons);
+  void               draw_symmetry_axes(QPainter &painter) const;
+  bool               is_mouse_cursor_on_img() const;
+  std::vector<Stamp> symmetric_stamps(const QPoint &pos, float angle) const;
+  void               update_geometry();
 
   std::string label;
   FloatField  field = FloatField(0, 0);
   FloatField  field_angle = FloatField(0, 0); // in [0, 1] == [-pi, pi]
+  FieldStats  field_stats;                     // of 'field' only
   bool        allow_angle_mode = false;
   std::string help_msg;
   QImage      bg_image = QImage();
@@ -67,16 +120,22 @@ private:
   int   canvas_height;
   QRect rect_img;
   //
-  bool             is_hovered = false;
-  bool             ctrl_pressed = false;
-  bool             shift_pressed = false;
-  bool             is_drawing = false;
-  bool             angle_mode = false;
-  bool             show_bg_image = true;
-  Qt::MouseButtons drawing_buttons;
-  int              brush_radius = 32;
-  float            brush_strength = 0.05f;
-  QPoint           pos_previous;
+  bool                 is_hovered = false;
+  bool                 ctrl_pressed = false;
+  bool                 shift_pressed = false;
+  bool                 is_drawing = false;
+  bool                 angle_mode = false;
+  bool                 show_bg_image = true;
+  SymmetryMode         symmetry_mode = SymmetryMode::NO_SYMMETRY;
+  int                  radial_symmetry_order = 6;
+  Tool                 tool = Tool::BRUSH;
+  bool                 is_lassoing = false;
+  float                lasso_value = 1.f;
+  std::vector<QPointF> lasso_points = {};
+  Qt::MouseButtons     drawing_buttons;
+  int                  brush_radius = 32;
+  float                brush_strength = 0.05f;
+  QPoint               pos_previous;
 };
 
 } // namespace qsx
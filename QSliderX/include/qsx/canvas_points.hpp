@@ -2,12 +2,29 @@
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
 #pragma once
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <span>
+
+#include <QFont>
 #include <QImage>
+#include <QPainter>
+#include <QStaticText>
 #include <QWidget>
 
+#include "qsx/internal/points_rasterizer.hpp"
+#include "qsx/internal/uniform_grid.hpp"
+
 namespace qsx
 {
 
+enum PathSimplification : int
+{
+  RAMER_DOUGLAS_PEUCKER, ///< Remove vertices closer than the tolerance to the path
+  VISVALINGAM_WHYATT,    ///< Remove vertices by increasing effective triangle area
+};
+
 class CanvasPoints : public QWidget
 {
   Q_OBJECT
@@ -23,21 +40,75 @@ public:
                const std::string &value_format_ = "{:.2f}",
                QWidget           *parent = nullptr);
 
-  std::vector<float> get_points_x() const;
-  std::vector<float> get_points_y() const;
-  std::vector<float> get_points_z() const;
-  void               set_bg_image(const QImage &new_bg_image);
-  void               set_connected_points(bool new_state);
-  void               set_draw_z_value(bool new_state);
-  std::string        get_value_as_string(float v) const;
-  void               set_is_dragging(bool new_state);
+  std::vector<float>     get_points_x() const;
+  std::vector<float>     get_points_y() const;
+  std::vector<float>     get_points_z() const;
+  std::span<const float> get_points_x_span() const; // no copy, invalidated by edits
+  std::span<const float> get_points_y_span() const;
+  std::span<const float> get_points_z_span() const;
+  void                   set_bg_image(const QImage &new_bg_image);
+  void                   set_connected_points(bool new_state);
+  void                   set_draw_z_value(bool new_state);
+  std::string            get_value_as_string(float v) const;
+  void                   set_is_dragging(bool new_state);
   void set_points(const std::vector<float> &new_x, const std::vector<float> &new_y);
   void set_points(const std::vector<float> &new_x,
                   const std::vector<float> &new_y,
                   const std::vector<float> &new_z);
+  void set_points(std::vector<float> &&new_x,
+                  std::vector<float> &&new_y,
+                  std::vector<float> &&new_z);
   void set_points_x(const std::vector<float> &new_x);
+  void set_points_x(std::vector<float> &&new_x);
   void set_points_y(const std::vector<float> &new_y);
+  void set_points_y(std::vector<float> &&new_y);
   void set_points_z(const std::vector<float> &new_z);
+  void set_points_z(std::vector<float> &&new_z);
+
+  // history of the interactive and path edits, the set_points* methods clear
+  // it, each step only touches the points affected by the edit
+  void clear_history();
+  bool redo();
+  bool undo();
+
+  // selection, point ids sorted in increasing order
+  void             clear_selection();
+  std::vector<int> get_selection() const;
+  void select_in_polygon(const std::vector<QPointF> &polygon, bool add = false);
+  void select_in_rect(float x0, float y0, float x1, float y1, bool add = false);
+  void transform_selection(float dx, float dy, float scale = 1.f, float angle = 0.f);
+
+  // replace the points by Poisson-disk distributed points, 'radius' is the
+  // minimum distance in canvas units, locally scaled by 1 / sqrt(density) when
+  // a density field (values in [0, 1] over the canvas) is given
+  void generate_poisson_disk_points(float             radius,
+                                    uint32_t          seed = 0,
+                                    const FloatField &density = FloatField(0, 0));
+
+  // Euclidean distance, in cells, to the rasterized path or to the points
+  // when they are not connected, clamped to 'max_distance' if positive (then
+  // dragging a point only recomputes the distances around it)
+  const FloatField &get_distance_field();
+  void set_distance_field(int width, int height, float max_distance = 0.f);
+
+  // rasterization of the (x, y, z) samples over the canvas domain (radius in
+  // canvas units), fully recomputed on request after bulk edits, only around
+  // the point while dragging a single point
+  const FloatField &get_rasterized_points();
+  void              set_rasterization(int                 width,
+                                      int                 height,
+                                      PointsRasterization method = INVERSE_DISTANCE,
+                                      float               radius = 0.1f);
+
+  // point cloud files, see qsx/internal/point_cloud_io.hpp for the formats
+  bool load_points_binary(const std::string &fname, int decimation = 1);
+  bool load_points_csv(const std::string &fname, int decimation = 1);
+  bool save_points_binary(const std::string &fname) const;
+  bool save_points_csv(const std::string &fname) const;
+
+  // path edits following the points order, end points are kept
+  void resample_path(int n); // evenly spaced along the arc length
+  void simplify_path(float tolerance, PathSimplification method = RAMER_DOUGLAS_PEUCKER);
 
   QSize sizeHint() const override;
 
@@ -45,8 +116,15 @@ signals:
   void value_changed(); // always
   void edit_ended();    // only end of edit
 
+  // edit deltas, emitted before value_changed()
+  void point_inserted(int idx);
+  void point_moved(int idx, float x, float y); // position or z value changed
+  void point_removed(int idx);
+  void points_reset(); // bulk edit, all the points may have changed
+
 protected:
   bool event(QEvent *event) override;
+  void keyPressEvent(QKeyEvent *event) override;
   void mouseDoubleClickEvent(QMouseEvent *event) override;
   void mouseMoveEvent(QMouseEvent *event) override;
   void mousePressEvent(QMouseEvent *event) override;
@@ -56,12 +134,53 @@ protected:
   void wheelEvent(QWheelEvent *event) override;
 
 private:
+  // history entry, the operation reverting an edit, turned into its own
+  // inverse when applied
+  struct EditOp
+  {
+    enum class Type
+    {
+      MOVE,   // restore the values of the points 'ids'
+      INSERT, // insert back the points at 'ids'
+      REMOVE, // remove the points 'ids'
+      RESET,  // restore the whole arrays
+    };
+
+    Type               type;
+    std::vector<int>   ids = {}; // sorted
+    std::vector<float> x = {};
+    std::vector<float> y = {};
+    std::vector<float> z = {};
+
+    size_t bytes() const;
+  };
+
   void   add_point(float x, float y);
-  void   canvas_position_to_xy(QPoint pos, float &x, float &y);
-  int    find_path_insertion_index(float x, float y) const;
+  void   apply_edit_op(EditOp &op);
+  void   apply_selection_transform(float dx, float dy, float scale, float angle);
+  void   begin_selection_transform();
+  void   canvas_position_to_xy(QPoint pos, float &x, float &y) const;
+  void   draw_distance_seeds(const QRect &region);
+  void   draw_points(QPainter &painter);
+  int    find_hovered_point(const QPoint &mouse_pos);
+  int    find_path_insertion_index(float x, float y);
+  bool   is_point_selected(int idx) const;
+  void   move_point_in_spatial_index(int idx, float x_before, float y_before);
+  void   push_history(EditOp &&op);
   void   remove_point(int idx);
+  void   replace_points(std::vector<float> &&new_x,
+                        std::vector<float> &&new_y,
+                        std::vector<float> &&new_z,
+                        bool                record_history);
+  void   set_selection(std::vector<int> &&ids, bool add);
+  void   show_context_menu();
+  bool   step_history(std::deque<EditOp> &from, std::deque<EditOp> &to);
+  void   update_density_image();
+  void   update_distance_field_point(int idx, float x_before, float y_before);
   void   update_geometry();
-  QPoint xy_to_canvas_position(float x, float y);
+  void   update_rasterized_point(int idx, float x_before, float y_before);
+  void   update_spatial_index();
+  QPoint xy_to_canvas_position(float x, float y) const;
 
   std::string        label;
   float              xmin;
@@ -76,6 +195,19 @@ private:
   std::vector<float> points_z = {}; // value at pt in [0, 1]
   QImage             bg_image = QImage();
   //
+  UniformGrid points_grid;   // point ids
+  UniformGrid segments_grid; // segment ids (k for [k, k + 1]), path mode only
+  bool        is_spatial_index_dirty = true;
+  QImage      density_image; // large sets only
+  bool        is_density_image_dirty = true;
+  //
+  PointsRasterizer rasterizer;
+  bool             is_rasterization_dirty = true;
+  FloatField       distance_seeds = FloatField(0, 0);
+  FloatField       distance_field = FloatField(0, 0);
+  float            distance_max = 0.f;
+  bool             is_distance_field_dirty = true;
+  //
   int   base_dx;
   int   base_dy;
   int   canvas_width;
@@ -83,12 +215,30 @@ private:
   QRect rect_points;
   QRect rect_label;
   //
+  QFont                value_font; // hovered point values
+  QStaticText          value_text;
+  std::array<float, 4> value_text_key; // point id and values value_text is laid out for
+  //
   bool   is_dragging = false;
   bool   is_hovered = false;
   int    hovered_point_id = -1;
   float  value_x_before_dragging;
   float  value_y_before_dragging;
   QPoint mouse_pos_before_dragging;
+  //
+  std::vector<int>    selected_ids = {};
+  std::vector<float>  selection_x_before = {}; // selected points before transform
+  std::vector<float>  selection_y_before = {};
+  float               selection_cx = 0.f; // pivot, selection centroid
+  float               selection_cy = 0.f;
+  bool                is_dragging_selection = false;
+  bool                is_selecting = false;
+  bool                is_lasso_selecting = false;
+  std::vector<QPoint> selection_path = {}; // rubber-band corners or lasso vertices
+  //
+  std::deque<EditOp> undo_stack = {};
+  std::deque<EditOp> redo_stack = {};
+  size_t             history_bytes = 0; // both stacks
 };
 
 } // namespace qsx
@@ -51,6 +51,16 @@ public:
     float  bg_image_alpha = 1.f;
     bool   flip_i = false;
     bool   flip_j = true;
+    int    stats_bins = 32;
+    int    stats_tile_size = 64;
+    float  fill_tolerance = 0.02f;
+    bool   fill_connectivity8 = false;
+    int    lod_point_threshold = 2000;
+    int    lod_detail_radius = 48;
+    float  selection_scale_step = 0.05f;
+    float  selection_rotation_step = 5.f;    // degrees
+    float  path_simplify_tolerance = 0.005f; // relative to the canvas diagonal
+    size_t history_max_bytes = 64 << 20;     // points edit history budget
   } canvas;
 
   struct Slider
@@ -82,8 +92,17 @@ public:
 
   struct Curve
   {
-    bool draw_sampling_points = true;
-    int  sampling_point_radius = 1;
+    bool   draw_sampling_points = true; // overlay of the get_values() samples
+    int    sampling_point_radius = 1;
+    int    lut_size = 4096;            // tables used by CurveEditor::apply
+    float  flatness_tolerance = 0.25f; // pixels, displayed curve subdivision
+    float  inactive_channel_alpha = 0.35f;
+    int    histogram_bins = 256; // CurveEditor::set_histogram_data backdrop
+    QColor color_red = QColor("#D95C5C");
+    QColor color_green = QColor("#5CB85C");
+    QColor color_blue = QColor("#5C8AD9");
+    QColor color_alpha = QColor("#A0A0A0");
+    QColor color_histogram = QColor("#3C3C3C");
   } curve;
 
 private:
@@ -1,17 +1,35 @@
 /* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General Public
    License. The full license is in the file LICENSE, distributed with this software. */
 #pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include <QMouseEvent>
 #include <QPainter>
+#include <QPainterPath>
+#include <QPixmap>
 #include <QVector>
 #include <QWidget>
 
+#include "qsx/internal/interpolate1d.hpp"
+#include "qsx/internal/piecewise_cubic.hpp"
+
 namespace qsx
 {
 
+enum CurveChannels : int
+{
+  CHANNELS_SINGLE, ///< One curve
+  CHANNELS_RGB,    ///< Master, red, green and blue curves
+  CHANNELS_RGBA,   ///< Master, red, green, blue and alpha curves
+};
+
 class CurveEditor : public QWidget
 {
   Q_OBJECT
@@ -21,19 +39,63 @@ public:
                        int                sample_count_ = 8,
                        QWidget           *parent = nullptr);
 
-  void               clear_points();
-  int                get_sample_count() const;
-  bool               get_smooth_interpolation() const;
-  std::vector<float> get_values() const;
-  void               set_control_points(const std::vector<QPointF> &new_control_points);
-  void               set_sample_count(int new_sample_count);
-  void               set_smooth_interpolation(bool new_state);
+  ~CurveEditor() override;
+
+  // map the values in [0, 1] through the curve (linear interpolation of a
+  // cached table of QSX_CONFIG->curve.lut_size samples), 'in' and 'out' may
+  // be the same buffer, large buffers are split across threads
+  void apply(std::span<const float> in, std::span<float> out, int channel = 0) const;
+
+  // same for interleaved pixels, 3 (RGB) or 4 (RGBA) values per pixel
+  // depending on the channels, 1 for a single curve, in a single pass
+  void apply_interleaved(std::span<const float> in, std::span<float> out) const;
+
+  // 'n' samples of the curve evenly spaced over [0, 1]
+  std::vector<float> bake_lut(int n, int channel = 0) const;
+
+  // 'n' samples of each color channel composed with the master curve (alpha
+  // excluded), interleaved, the single curve alone for CHANNELS_SINGLE
+  std::vector<float> bake_lut_interleaved(int n) const;
+
+  void                                 clear_histogram();
+  void                                 clear_points(); // active channel
+  int                                  get_active_channel() const;
+  int                                  get_channel_count() const; // curves
+  CurveChannels                        get_channels() const;
+  std::optional<InterpolationMethod1D> get_interpolation_method() const;
+  int                                  get_sample_count() const;
+  bool                                 get_smooth_interpolation() const;
+  std::vector<float>                   get_values(int channel = 0) const;
+  void                                 set_active_channel(int new_channel);
+
+  // several curves in one widget, edited through channel tabs, the master
+  // curve has the index 0, all the curves are reset
+  void set_channels(CurveChannels new_channels);
+
+  // histogram of the values in [0, 1] drawn behind the curves, binned on a
+  // worker thread (QSX_CONFIG->curve.histogram_bins bins), 'data' is not
+  // copied and must stay valid until histogram_ready() is emitted or the
+  // histogram is replaced or cleared
+  void set_histogram_data(std::span<const float> data);
+
+  void set_control_points(const std::vector<QPointF> &new_control_points,
+                          int                         channel = 0);
+  void set_sample_count(int new_sample_count);
+
+  // spline through the control points, falls back to linear interpolation
+  // while the points do not suit the method (too few points, points sharing
+  // the same x, non-monotonic values for Steffen), Catmull-Rom or linear
+  // (see set_smooth_interpolation) when not set
+  void set_interpolation_method(std::optional<InterpolationMethod1D> new_method);
+
+  void set_smooth_interpolation(bool new_state);
 
   QSize sizeHint() const override;
 
 signals:
-  void value_changed(); // always
-  void edit_ended();    // only end of edit
+  void value_changed();   // always
+  void edit_ended();      // only end of edit
+  void histogram_ready(); // binning done, backdrop updated
 
 protected:
   bool event(QEvent *event) override;
@@ -41,27 +103,65 @@ protected:
   void mousePressEvent(QMouseEvent *event) override;
   void mouseMoveEvent(QMouseEvent *event) override;
   void mouseReleaseEvent(QMouseEvent *event) override;
+  void resizeEvent(QResizeEvent *event) override;
 
 private:
+  struct Channel
+  {
+    std::string                     name;
+    QColor                          color;
+    std::vector<QPointF>            control_points;
+    PiecewiseCubic                  curve; // rebuilt when the control points change
+    std::unique_ptr<Interpolator1D> interpolator;            // null when falling back
+    bool                            is_falling_back = false; // to linear
+    bool                            clamp_values = true;     // spline overshoot
+    std::vector<float>              values;
+    std::vector<float>              lut;        // used by apply()
+    QPainterPath                    curve_path; // screen space, adaptive subdivision
+    bool                            is_curve_path_dirty = true;
+  };
+
   void    draw_background(QPainter &painter);
   void    draw_curve(QPainter &painter);
+  void    draw_histogram(QPainter &painter);
   void    draw_points(QPainter &painter);
+  void    draw_tabs(QPainter &painter);
+  float   evaluate(const Channel &ch, float t) const; // random access, displayed value
   int     find_nearest_point(const QPoint &pos) const;
   QPointF point_to_screen(const QPointF &p) const;
-  float   interpolate(float t) const;
-  float   interpolate_catmull_rom(float t) const;
-  float   interpolate_linear(float t) const;
+  void    sample_curve(const Channel &ch, std::span<float> out, float x0, float x1) const;
   QPointF screen_to_point(const QPoint &p) const;
-  void    update_values();
+  void    stop_histogram_worker();
+  void    update_all_channels();
+  void    update_channel(Channel &ch, int first = 0, int last = -1);
+  void    update_curve(Channel &ch);
+  void    update_curve_path(Channel &ch);
+  void    update_histogram_pixmap();
+  void    update_interleaved_lut();
+  void    update_tab_rects();
+  void    update_values(int first = 0, int last = -1); // active channel
 
   std::string          label;
-  std::vector<QPointF> control_points;
-  std::vector<float>   values;
+  std::vector<Channel> channels;
+  CurveChannels        channels_mode = CHANNELS_SINGLE;
+  int                  active_channel = 0;
+  std::vector<QRect>   rect_tabs;       // one per channel, empty for a single curve
+  std::vector<float>   lut_interleaved; // used by apply_interleaved()
   int                  sample_count;
   bool                 smooth_interpolation = true;
-  int                  active_point = -1;
-  bool                 is_dragging = false;
-  bool                 is_hovered = false;
+  //
+  std::optional<InterpolationMethod1D> interpolation_method = std::nullopt;
+  //
+  std::vector<uint64_t> histogram;        // bins, empty when not set
+  QPixmap               histogram_pixmap; // bins area size, rebuilt after a resize
+  bool                  is_histogram_pixmap_dirty = true;
+  std::thread           histogram_worker;
+  std::atomic<bool>     histogram_cancel = false;
+  int                   histogram_generation = 0; // drops the results of replaced data
+  //
+  int  active_point = -1;
+  bool is_dragging = false;
+  bool is_hovered = false;
 };
 
 } // namespace qsx
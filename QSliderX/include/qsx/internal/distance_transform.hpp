@@ -0,0 +1,34 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#pragma once
+#include <QRect>
+
+#include "qsx/internal/float_field.hpp"
+
+namespace qsx
+{
+
+// exact Euclidean distance transform (Felzenszwalb-Huttenlocher, separable),
+// distance in cells to the nearest cell with a non-zero seed value, clamped
+// to 'max_distance' if positive, columns and then rows are processed in
+// parallel
+//
+// with a valid 'region' and a positive 'max_distance' only the cells of the
+// region are computed, from the seeds within 'max_distance' of it
+void distance_transform(const FloatField &seeds,
+                        FloatField       &distance,
+                        float             max_distance = 0.f,
+                        const QRect      &region = QRect());
+
+// set to 'value' the cells crossed by the segment (in cell coordinates, cell
+// (i, j) covering [i, i + 1) x [j, j + 1)), only within 'clip' if valid
+void draw_segment(FloatField  &field,
+                  float        x0,
+                  float        y0,
+                  float        x1,
+                  float        y1,
+                  float        value = 1.f,
+                  const QRect &clip = QRect());
+
+} // namespace qsx
@@ -0,0 +1,58 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "qsx/internal/float_field.hpp"
+
+namespace qsx
+{
+
+// statistics (min, max, mean and histogram over [0, 1]) of a field, stored
+// per tile so that only the tiles overlapping an edited region need to be
+// recomputed
+class FieldStats
+{
+public:
+  FieldStats(int nbins_ = 32, int tile_size_ = 64);
+
+  float get_max() const;
+  float get_mean() const;
+  float get_min() const;
+  int   get_nbins() const;
+
+  // bin centers / bin counts
+  std::pair<std::vector<float>, std::vector<float>> get_histogram() const;
+
+  // recompute everything, also handles field size changes
+  void reset(const FloatField &field);
+
+  // recompute the tiles overlapping the pixel region [x0, x1] x [y0, y1]
+  void update(const FloatField &field, int x0, int y0, int x1, int y1);
+
+private:
+  struct Tile
+  {
+    float  min;
+    float  max;
+    double sum;
+  };
+
+  void update_tile(const FloatField &field, int ti, int tj);
+
+  int                   nbins;
+  int                   tile_size;
+  int                   width = 0;
+  int                   height = 0;
+  int                   ntiles_i = 0;
+  int                   ntiles_j = 0;
+  std::vector<Tile>     tiles;
+  std::vector<uint32_t> tiles_hist; // ntiles x nbins
+  std::vector<uint64_t> hist;       // aggregated histogram
+  double                sum = 0.0;  // aggregated sum
+};
+
+} // namespace qsx
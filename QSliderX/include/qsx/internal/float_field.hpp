@@ -4,9 +4,20 @@
 #pragma once
 #include <vector>
 
+#include <QPointF>
+#include <QRect>
+
 namespace qsx
 {
 
+enum ResampleFilter : int
+{
+  BOX,      ///< Box filter (nearest neighbor when upsampling)
+  BILINEAR, ///< Bilinear (tent) filter
+  BICUBIC,  ///< Bicubic filter (Catmull-Rom kernel)
+  LANCZOS,  ///< Lanczos filter (3 lobes)
+};
+
 struct FloatField
 {
   FloatField(int w, int h) : width(w), height(h), data(w * h, 0.0f) {}
@@ -19,4 +30,24 @@ struct FloatField
   std::vector<float> data;
 };
 
-} // namespace qsx
\ No newline at end of file
+// fill the 4- or 8-connected region of cells whose value is within
+// 'tolerance' of the seed cell value, returns the filled region
+QRect flood_fill(FloatField &field,
+                 int         x,
+                 int         y,
+                 float       value,
+                 float       tolerance = 0.f,
+                 bool        connectivity8 = false);
+
+// fill the cells whose center lies inside the polygon (even-odd rule),
+// returns the filled region
+QRect fill_polygon(FloatField &field, const std::vector<QPointF> &polygon, float value);
+
+// separable resampling of the field to a new resolution, rows are
+// processed in parallel
+FloatField resample(const FloatField &src,
+                    int               new_width,
+                    int               new_height,
+                    ResampleFilter    filter = ResampleFilter::BILINEAR);
+
+} // namespace qsx
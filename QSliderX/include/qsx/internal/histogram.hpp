@@ -0,0 +1,20 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace qsx
+{
+
+// counts of the values of 'data' in 'nbins' bins evenly spread over [0, 1],
+// values outside of [0, 1] and NaN are not counted, computed by blocks split
+// across threads, returns an empty histogram when 'cancel' is set meanwhile
+std::vector<uint64_t> compute_histogram(std::span<const float>   data,
+                                        int                      nbins,
+                                        const std::atomic<bool> &cancel);
+
+} // namespace qsx
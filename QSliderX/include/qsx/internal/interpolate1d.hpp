@@ -3,11 +3,15 @@
    this software. */
 #pragma once
 #include <map>
+#include <memory>
+#include <span>
 #include <vector>
 
 #include <gsl/gsl_interp.h>
 #include <gsl/gsl_spline.h>
 
+#include "qsx/internal/piecewise_cubic.hpp"
+
 namespace qsx
 {
 
@@ -22,24 +26,40 @@ enum InterpolationMethod1D : int
   STEFFEN,        ///< Steffen interpolation (monotonic)
 };
 
+enum InterpolationEngine1D : int
+{
+  ENGINE_GSL,    ///< GSL splines, double precision
+  ENGINE_NATIVE, ///< Single precision segments (AKIMA, CUBIC, LINEAR and STEFFEN)
+};
+
+// the spline is immutable once built and shared by the copies, the
+// evaluation methods only use per-call accelerators and can be called from
+// several threads at once
 class Interpolator1D
 {
 public:
   Interpolator1D(const std::vector<float> &x,
                  const std::vector<float> &y,
-                 InterpolationMethod1D     method = InterpolationMethod1D::LINEAR);
-  ~Interpolator1D();
+                 InterpolationMethod1D     method = InterpolationMethod1D::LINEAR,
+                 InterpolationEngine1D     engine_ = ENGINE_GSL);
+
+  // engine actually used, the methods not supported by the native engine
+  // always use GSL
+  InterpolationEngine1D get_engine() const;
 
   float operator()(float x) const;
   float interpolate(float x) const;
 
+  // y[i] = interpolate(x[i]), a single forward sweep over the segments for
+  // increasing x values (binary search when going backward)
+  void evaluate(std::span<const float> x, std::span<float> y) const;
+
 private:
-  gsl_spline         *interp; ///< GSL spline object used for interpolation
-  gsl_interp_accel   *accel_; ///< GSL interpolation accelerator
-  std::vector<double> x_data; ///< x data converted to double for GSL
-  std::vector<double> y_data; ///< y data converted to double for GSL
-  double              xmin;   ///< Minimum x value in the data set
-  double              xmax;   ///< Maximum x value in the data set
+  std::shared_ptr<const gsl_spline> interp; ///< GSL spline object used for interpolation
+  PiecewiseCubic                    native; ///< Segments used by the native engine
+  InterpolationEngine1D             engine; ///< Engine used for the evaluation
+  double                            xmin;   ///< Minimum x value in the data set
+  double                            xmax;   ///< Maximum x value in the data set
 };
 
 } // namespace qsx
@@ -0,0 +1,18 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#pragma once
+#include <functional>
+
+namespace qsx
+{
+
+// split the range [begin, end) into contiguous chunks of at least 'grain'
+// items and call fct(chunk_begin, chunk_end) for each of them on worker
+// threads, returns once all the chunks have been processed
+void parallel_for(int                                 begin,
+                  int                                 end,
+                  const std::function<void(int, int)> &fct,
+                  int                                 grain = 1);
+
+} // namespace qsx
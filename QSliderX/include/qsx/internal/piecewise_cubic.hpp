@@ -0,0 +1,84 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#pragma once
+#include <array>
+#include <span>
+#include <vector>
+
+namespace qsx
+{
+
+// piecewise cubic polynomial over increasing knots, on the segment k
+// (x in [x_k, x_k+1]) y = a + b dx + c dx^2 + d dx^3 with dx = x - x_k,
+// constant extrapolation outside of the knots
+//
+// the segments are located through a uniform grid over the knots range, each
+// cell storing the segment at its start
+class PiecewiseCubic
+{
+public:
+  PiecewiseCubic() = default;
+
+  // random access
+  float evaluate(float x) const;
+
+  // any order, by blocks: the segments are located first, then the
+  // polynomials are evaluated in a branch-free loop vectorized by the compiler
+  void evaluate(std::span<const float> x, std::span<float> y) const;
+
+  // increasing 'x', single forward sweep over the segments (falls back to the
+  // grid lookup when the input goes backward)
+  void evaluate_sorted(std::span<const float> x, std::span<float> y) const;
+
+  int  find_segment(float x) const; // in [0, n - 2]
+  bool is_empty() const { return this->knots.empty(); }
+
+  // replace the knots starting at 'first' (same count, still increasing) and
+  // recompute only the segments depending on them (all of them for the
+  // Akima, natural cubic and Steffen curves)
+  void move_knots(int first, std::span<const float> x, std::span<const float> y);
+
+  // same segments as the GSL akima, cspline and steffen interpolations
+  // (non-periodic, natural boundary conditions for the cubic spline),
+  // coefficients computed in double precision, linear below 3 knots
+  void set_akima(std::span<const float> x, std::span<const float> y);
+  void set_natural_cubic(std::span<const float> x, std::span<const float> y);
+  void set_steffen(std::span<const float> x, std::span<const float> y);
+
+  // uniform Catmull-Rom segments, the tangents use the neighbor values in the
+  // local segment parameter (end points duplicated)
+  void set_catmull_rom(std::span<const float> x, std::span<const float> y);
+
+  void set_linear(std::span<const float> x, std::span<const float> y);
+
+private:
+  enum class Kind
+  {
+    LINEAR,
+    CATMULL_ROM,
+    AKIMA,
+    NATURAL_CUBIC,
+    STEFFEN,
+  };
+
+  void  build_akima();
+  void  build_natural_cubic();
+  void  build_segments(); // all of them, then the grid
+  void  build_steffen();
+  float evaluate_segment(int k, float x) const;
+  void  reset_knots(std::span<const float> x, std::span<const float> y);
+  void  set_hermite_segment(int k, double t0, double t1); // end point tangents
+  void  set_segment(int k); // from the knots and their values, local kinds only
+  void  update_grid();
+
+  Kind                              kind = Kind::LINEAR;
+  std::vector<float>                knots;
+  std::vector<float>                knot_values;
+  std::vector<std::array<float, 4>> coeffs; // (a, b, c, d), one per segment
+  std::vector<int>                  grid;   // segment at the start of each cell
+  float                             grid_x0 = 0.f;
+  float                             grid_scale = 0.f; // cells per unit
+};
+
+} // namespace qsx
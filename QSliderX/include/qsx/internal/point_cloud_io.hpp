@@ -0,0 +1,42 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#pragma once
+#include <span>
+#include <string>
+#include <vector>
+
+namespace qsx
+{
+
+// point cloud readers and writers, errors are logged and reported by a false
+// return value, 'decimation' keeps only one point every 'decimation' points
+
+// CSV with x, y[, z] columns separated by commas, semicolons or blanks, lines
+// that cannot be parsed (header, comments) are skipped and a missing z
+// defaults to 1
+bool read_points_csv(const std::string  &fname,
+                     std::vector<float> &x,
+                     std::vector<float> &y,
+                     std::vector<float> &z,
+                     int                 decimation = 1);
+
+bool write_points_csv(const std::string     &fname,
+                      std::span<const float> x,
+                      std::span<const float> y,
+                      std::span<const float> z);
+
+// binary structure of arrays, little-endian: "QSXP" magic, uint32 version,
+// uint64 point count, then the x, y and z float32 arrays
+bool read_points_binary(const std::string  &fname,
+                        std::vector<float> &x,
+                        std::vector<float> &y,
+                        std::vector<float> &z,
+                        int                 decimation = 1);
+
+bool write_points_binary(const std::string     &fname,
+                         std::span<const float> x,
+                         std::span<const float> y,
+                         std::span<const float> z);
+
+} // namespace qsx
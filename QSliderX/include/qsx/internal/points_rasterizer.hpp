@@ -0,0 +1,76 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#pragma once
+#include <span>
+#include <vector>
+
+#include <QRect>
+
+#include "qsx/internal/float_field.hpp"
+#include "qsx/internal/uniform_grid.hpp"
+
+namespace qsx
+{
+
+enum PointsRasterization : int
+{
+  INVERSE_DISTANCE,   ///< Modified Shepard, nearest points within the support radius
+  GAUSSIAN_SPLATTING, ///< Normalized sum of Gaussian kernels truncated at the radius
+  THIN_PLATE_SPLINE,  ///< Thin-plate radial basis functions, global (small sets only)
+};
+
+// rasterization of scattered (x, y, z) samples onto a field covering the
+// domain [xmin, xmax] x [ymin, ymax], the field index i maps to x and j to y
+// (from ymin), cells without any point within the support radius are set
+// to 0
+class PointsRasterizer
+{
+public:
+  PointsRasterizer() = default;
+
+  const FloatField &get_field() const { return this->field; }
+
+  // full rasterization
+  void rasterize(std::span<const float> x,
+                 std::span<const float> y,
+                 std::span<const float> z);
+
+  void set_domain(float xmin_, float xmax_, float ymin_, float ymax_);
+  void set_method(PointsRasterization method_, float radius_, int neighbors_ = 8);
+  void set_size(int width, int height);
+
+  // point 'idx' moved from (x_before, y_before) (or its z value changed),
+  // recompute only the affected cells and return them, the whole field for
+  // the thin-plate spline
+  QRect update_point(std::span<const float> x,
+                     std::span<const float> y,
+                     std::span<const float> z,
+                     int                    idx,
+                     float                  x_before,
+                     float                  y_before);
+
+private:
+  QRect cells_around(float x, float y) const; // cells within the radius
+  void  rasterize_region(std::span<const float> x,
+                         std::span<const float> y,
+                         std::span<const float> z,
+                         const QRect           &region);
+  bool  solve_thin_plate(std::span<const float> x,
+                         std::span<const float> y,
+                         std::span<const float> z);
+
+  FloatField          field = FloatField(0, 0);
+  float               xmin = 0.f;
+  float               xmax = 1.f;
+  float               ymin = 0.f;
+  float               ymax = 1.f;
+  PointsRasterization method = INVERSE_DISTANCE;
+  float               radius = 0.1f;
+  int                 neighbors = 8;
+  UniformGrid         grid;
+  bool                use_thin_plate = false; // false when falling back to IDW
+  std::vector<double> tps_weights;            // n point weights + 3 affine terms
+};
+
+} // namespace qsx
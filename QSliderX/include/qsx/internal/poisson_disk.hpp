@@ -0,0 +1,31 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "qsx/internal/float_field.hpp"
+
+namespace qsx
+{
+
+// Bridson's Poisson-disk sampling of the domain [xmin, xmax] x [ymin, ymax]
+// with a minimum distance 'radius' between points and 'k' candidates per
+// active point
+//
+// with a non-empty density field (values in [0, 1] covering the domain, i
+// maps to x and j to y) the local minimum distance becomes
+// radius / sqrt(density), with the density clamped to [1 / 16, 1]
+void poisson_disk_sampling(float               xmin,
+                           float               xmax,
+                           float               ymin,
+                           float               ymax,
+                           float               radius,
+                           std::vector<float> &x,
+                           std::vector<float> &y,
+                           uint32_t            seed = 0,
+                           const FloatField   &density = FloatField(0, 0),
+                           int                 k = 30);
+
+} // namespace qsx
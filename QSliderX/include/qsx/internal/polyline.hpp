@@ -0,0 +1,38 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#pragma once
+#include <span>
+#include <vector>
+
+namespace qsx
+{
+
+// polyline simplification, return the (sorted) indices of the kept vertices,
+// the end points are always kept
+
+// Ramer-Douglas-Peucker, vertices closer than 'tolerance' to the simplified
+// polyline are removed, O(n log n) on average only: O(n^2) in the worst case
+// (a single vertex split off at each step, e.g. long noisy paths), use
+// simplify_visvalingam for a worst-case O(n log n) simplification
+std::vector<int> simplify_rdp(std::span<const float> x,
+                              std::span<const float> y,
+                              float                  tolerance);
+
+// Visvalingam-Whyatt, vertices are removed by increasing effective triangle
+// area until the smallest area exceeds 'min_area', O(n log n)
+std::vector<int> simplify_visvalingam(std::span<const float> x,
+                                      std::span<const float> y,
+                                      float                  min_area);
+
+// resample the polyline to 'n' vertices evenly spaced along its arc length,
+// z is linearly interpolated along the segments
+void resample_arc_length(std::span<const float> x,
+                         std::span<const float> y,
+                         std::span<const float> z,
+                         int                    n,
+                         std::vector<float>    &x_out,
+                         std::vector<float>    &y_out,
+                         std::vector<float>    &z_out);
+
+} // namespace qsx
@@ -0,0 +1,47 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#pragma once
+#include <vector>
+
+namespace qsx
+{
+
+// uniform grid over a rectangular domain, items are stored by id in every
+// cell overlapped by their bounding box (items outside the domain are
+// clamped to the border cells)
+class UniformGrid
+{
+public:
+  UniformGrid() = default;
+
+  void  clear();
+  float get_cell_size() const; // largest cell dimension
+  void  insert(int id, float x0, float y0, float x1, float y1);
+  void  insert(int id, float x, float y) { this->insert(id, x, y, x, y); }
+
+  // append the ids stored in the cells overlapped by the query box, an item
+  // spanning several cells may be reported more than once
+  void query(float x0, float y0, float x1, float y1, std::vector<int> &ids) const;
+
+  // true if the query box covers the whole grid
+  bool query_covers_grid(float x0, float y0, float x1, float y1) const;
+
+  void remove(int id, float x0, float y0, float x1, float y1);
+  void remove(int id, float x, float y) { this->remove(id, x, y, x, y); }
+  void reset(float xmin_, float xmax_, float ymin_, float ymax_, int ni_, int nj_);
+
+private:
+  int cell_i(float x) const;
+  int cell_j(float y) const;
+
+  float                         xmin = 0.f;
+  float                         xmax = 1.f;
+  float                         ymin = 0.f;
+  float                         ymax = 1.f;
+  int                           ni = 0;
+  int                           nj = 0;
+  std::vector<std::vector<int>> cells;
+};
+
+} // namespace qsx
@@ -7,6 +7,7 @@
 #include <QHoverEvent>
 #include <QMessageBox>
 #include <QPainter>
+#include <QPointer>
 
 #include "qsx/canvas_field.hpp"
 #include "qsx/config.hpp"
@@ -21,8 +22,11 @@ CanvasField::CanvasField(const std::string &label_,
                          int                field_height,
                          QWidget           *parent)
     : QWidget(parent), field(field_width, field_height),
-      field_angle(field_width, field_height)
+      field_angle(field_width, field_height),
+      field_stats(QSX_CONFIG->canvas.stats_bins, QSX_CONFIG->canvas.stats_tile_size)
 {
+  this->field_stats.reset(this->field);
+
   this->label = truncate_string(label_,
                                 static_cast<size_t>(QSX_CONFIG->global.max_label_len));
 
@@ -34,12 +38,171 @@ CanvasField::CanvasField(const std::string &label_,
   this->help_msg = "Field editor\n- left-click: add\n- right-click substract\n- "
                    "mousewheel: brush radius\n- CTRL + mousewheel: brush strength\n- "
                    "SHIFT + left-click: smoothing\n- TAB: switch to angle mode\n- Key C: "
-                   "clear canvas\n - SPACE: toggle background image";
+                   "clear canvas\n - SPACE: toggle background image\n- Key M: cycle "
+                   "symmetry mode\n- Key F: flood fill tool\n- Key L: lasso fill tool";
   this->setToolTip(this->help_msg.c_str());
 
   this->update_geometry();
 }
 
+// helper, half-width of the brush footprint at a given row offset, i.e. the
+// largest hw such that hw^2 + dy^2 <= ir^2
+static int footprint_half_width(int ir, int dy)
+{
+  int rem = ir * ir - dy * dy;
+  int hw = SINT(std::sqrt(SFLOAT(rem)));
+
+  while (hw > 0 && hw * hw > rem)
+    hw--;
+  while ((hw + 1) * (hw + 1) <= rem)
+    hw++;
+
+  return hw;
+}
+
+QRect CanvasField::apply_stamps(const std::vector<Stamp> &stamps, float sign)
+{
+  if (stamps.empty())
+    return QRect();
+
+  const int ir = this->brush_radius;
+  const int navg = QSX_CONFIG->canvas.brush_avg_radius;
+  const int w = this->field.width;
+  const int h = this->field.height;
+
+  // local average of the field, used by the smoothing brush
+  auto average = [navg, w, h](const FloatField &f, int fx, int fy)
+  {
+    float sum = 0.f;
+    int   ns = 0;
+
+    for (int r = std::max(-navg, -fx); r < std::min(navg + 1, w - fx); r++)
+      for (int s = std::max(-navg, -fy); s < std::min(navg + 1, h - fy); s++)
+      {
+        sum += f.at(fx + r, fy + s);
+        ns++;
+      }
+
+    return std::clamp(sum / SFLOAT(ns), 0.f, 1.f);
+  };
+
+  // rows covered by the union of the footprints
+  int j0 = h;
+  int j1 = -1;
+
+  for (auto &stamp : stamps)
+  {
+    j0 = std::min(j0, stamp.y - ir);
+    j1 = std::max(j1, stamp.y + ir);
+  }
+
+  std::vector<std::pair<int, int>> spans;
+  spans.reserve(stamps.size());
+
+  int imin = w;
+  int imax = -1;
+
+  for (int j = std::max(j0, 0); j <= std::min(j1, h - 1); ++j)
+  {
+    // horizontal extent of each footprint crossing this row
+    spans.clear();
+
+    for (auto &stamp : stamps)
+    {
+      int dy = j - stamp.y;
+      if (std::abs(dy) > ir)
+        continue;
+
+      int hw = footprint_half_width(ir, dy);
+      int i0 = std::max(stamp.x - hw, 0);
+      int i1 = std::min(stamp.x + hw, w - 1);
+
+      if (i0 <= i1)
+        spans.push_back({i0, i1});
+    }
+
+    std::sort(spans.begin(), spans.end());
+
+    // merge overlapping spans so that pixels shared by several stamps
+    // are only written once
+    size_t k = 0;
+
+    while (k < spans.size())
+    {
+      int i0 = spans[k].first;
+      int i1 = spans[k].second;
+
+      for (++k; k < spans.size() && spans[k].first <= i1 + 1; ++k)
+        i1 = std::max(i1, spans[k].second);
+
+      imin = std::min(imin, i0);
+      imax = std::max(imax, i1);
+
+      for (int i = i0; i <= i1; ++i)
+      {
+        // strongest kernel value among the stamps covering this pixel
+        float falloff = -1.f;
+        float angle = 0.f;
+
+        for (auto &stamp : stamps)
+        {
+          int dx = i - stamp.x;
+          int dy = j - stamp.y;
+          int d2 = dx * dx + dy * dy;
+
+          if (d2 > ir * ir)
+            continue;
+
+          float f = 1.f - std::sqrt(SFLOAT(d2)) / SFLOAT(ir); // linear falloff
+          if (f > falloff)
+          {
+            falloff = f;
+            angle = stamp.angle;
+          }
+        }
+
+        if (falloff < 0.f)
+          continue;
+
+        if (this->shift_pressed)
+        {
+          // --- smoothing: lerp an averaged value based on the kernel value
+
+          float value_avg = average(this->field, i, j);
+          this->field.at(i, j) = (1.f - falloff) * this->field.at(i, j) +
+                                 falloff * value_avg;
+
+          // same for angle
+          if (this->allow_angle_mode)
+          {
+            float angle_avg = average(this->field_angle, i, j);
+            this->field_angle.at(i, j) = (1.f - falloff) * this->field_angle.at(i, j) +
+                                         falloff * angle_avg;
+          }
+        }
+        else
+        {
+          // --- regular add/remove value
+
+          float amp = sign * this->brush_strength;
+
+          this->field.at(i, j) += amp * falloff;
+          this->field.at(i, j) = std::clamp(this->field.at(i, j), 0.0f, 1.0f);
+
+          this->field_angle.at(i, j) = (1.f - falloff) * this->field_angle.at(i, j) +
+                                       falloff * angle;
+        }
+      }
+    }
+  }
+
+  // modified region
+  if (imin > imax)
+    return QRect();
+
+  return QRect(QPoint(imin, std::max(j0, 0)), QPoint(imax, std::min(j1, h - 1)));
+}
+
 QColor CanvasField::colormap(float v) const
 {
   v = std::clamp(v, 0.f, 1.f);
@@ -52,6 +215,7 @@ void CanvasField::clear()
 {
   this->field.clear();
   this->field_angle.clear();
+  this->field_stats.reset(this->field);
   this->update();
   Q_EMIT this->value_changed();
   Q_EMIT this->edit_ended();
@@ -65,120 +229,88 @@ void CanvasField::draw_at(const Qt::MouseButtons &buttons)
 
 void CanvasField::draw_at(const QPoint &pos, const Qt::MouseButtons &buttons)
 {
-  const QPoint center = pos;
-  const int    ir = this->brush_radius;
-  const int    navg = QSX_CONFIG->canvas.brush_avg_radius;
-  float        sign = (buttons & Qt::LeftButton) ? 1.f : -1.f;
+  float sign = (buttons & Qt::LeftButton) ? 1.f : -1.f;
+  float angle = 0.f;
 
-  if (this->shift_pressed)
+  if (!this->shift_pressed)
   {
-    // --- smoothing: compute an averaged value and lerp it based on the kernel value
-
-    for (int j = -ir; j <= ir; ++j)
-      for (int i = -ir; i <= ir; ++i)
-      {
-        int fx = center.x() + i;
-        int fy = center.y() + j;
-
-        if (fx < 0 || fy < 0 || fx >= this->field.width || fy >= this->field.height)
-          continue;
-
-        float dist = std::sqrt(SFLOAT(i * i + j * j));
-        bool  inside = (dist <= SFLOAT(ir));
-
-        if (inside)
-        {
-          // averaging
-          {
-            float sum = 0.f;
-            int   ns = 0;
-
-            for (int r = -navg; r < navg + 1; r++)
-              for (int s = -navg; s < navg + 1; s++)
-              {
-                if (fx + r < 0 || fy + s < 0 || fx + r >= this->field.width ||
-                    fy + s >= this->field.height)
-                  continue;
+    // stroke direction, only used by the regular add/remove brush
+    angle = std::atan2(SFLOAT(pos.y() - pos_previous.y()),
+                       SFLOAT(pos.x() - pos_previous.x()));
+    angle = 0.5f * (angle / SFLOAT(M_PI) + 1.f);
+    this->pos_previous = pos;
+  }
 
-                sum += this->field.at(fx + r, fy + s);
-                ns++;
-              }
+  // the original stamp and its symmetric copies are applied in a single pass
+  QRect dirty = this->apply_stamps(this->symmetric_stamps(pos, angle), sign);
 
-            float falloff = 1.f - (dist / SFLOAT(ir));
-            float value_avg = std::clamp(sum / SFLOAT(ns), 0.f, 1.f);
+  this->field_stats.update(this->field,
+                           dirty.left(),
+                           dirty.top(),
+                           dirty.right(),
+                           dirty.bottom());
 
-            this->field.at(fx, fy) = (1.f - falloff) * this->field.at(fx, fy) +
-                                     falloff * value_avg;
-          }
+  this->update();
+  Q_EMIT this->value_changed();
+}
 
-          // same for angle
-          if (this->allow_angle_mode)
-          {
-            float sum = 0.f;
-            int   ns = 0;
-
-            for (int r = -navg; r < navg + 1; r++)
-              for (int s = -navg; s < navg + 1; s++)
-              {
-                if (fx + r < 0 || fy + s < 0 || fx + r >= this->field_angle.width ||
-                    fy + s >= this->field_angle.height)
-                  continue;
-
-                sum += this->field_angle.at(fx + r, fy + s);
-                ns++;
-              }
-
-            float falloff = 1.f - (dist / SFLOAT(ir));
-            float value_avg = std::clamp(sum / SFLOAT(ns), 0.f, 1.f);
-
-            this->field_angle.at(fx, fy) = (1.f - falloff) *
-                                               this->field_angle.at(fx, fy) +
-                                           falloff * value_avg;
-          }
-        }
-      }
-  }
-  else
-  {
-    // --- regular add/remove value
+void CanvasField::draw_symmetry_axes(QPainter &painter) const
+{
+  if (this->symmetry_mode == SymmetryMode::NO_SYMMETRY)
+    return;
 
-    float angle = std::atan2(SFLOAT(pos.y() - pos_previous.y()),
-                             SFLOAT(pos.x() - pos_previous.x()));
-    angle = 0.5f * (angle / SFLOAT(M_PI) + 1.f);
-    this->pos_previous = pos;
+  const QPointF center = QRectF(this->rect_img).center();
+  const float   half_diag = 0.5f * std::hypot(SFLOAT(this->rect_img.width()),
+                                            SFLOAT(this->rect_img.height()));
 
-    // value
-    for (int j = -ir; j <= ir; ++j)
-      for (int i = -ir; i <= ir; ++i)
-      {
-        int fx = center.x() + i;
-        int fy = center.y() + j;
+  painter.save();
+  painter.setClipRect(this->rect_img);
+  painter.setPen(QPen(QSX_CONFIG->global.color_faded, 1, Qt::DashLine));
+  painter.setBrush(Qt::NoBrush);
 
-        if (fx < 0 || fy < 0 || fx >= this->field.width || fy >= this->field.height)
-          continue;
+  if (this->symmetry_mode == SymmetryMode::MIRROR_X ||
+      this->symmetry_mode == SymmetryMode::MIRROR_XY)
+    painter.drawLine(QPointF(center.x(), this->rect_img.top()),
+                     QPointF(center.x(), this->rect_img.bottom()));
 
-        float dist = std::sqrt(SFLOAT(i * i + j * j));
-        bool  inside = (dist <= SFLOAT(ir));
+  if (this->symmetry_mode == SymmetryMode::MIRROR_Y ||
+      this->symmetry_mode == SymmetryMode::MIRROR_XY)
+    painter.drawLine(QPointF(this->rect_img.left(), center.y()),
+                     QPointF(this->rect_img.right(), center.y()));
 
-        if (inside)
-        {
-          // reduce intensity when getting close to value saturation
-          float amp = sign * this->brush_strength;
+  if (this->symmetry_mode == SymmetryMode::RADIAL)
+    for (int k = 0; k < this->radial_symmetry_order; ++k)
+    {
+      float phi = 2.f * SFLOAT(M_PI) * SFLOAT(k) / SFLOAT(this->radial_symmetry_order);
+      painter.drawLine(center,
+                       center + QPointF(half_diag * std::cos(phi),
+                                        half_diag * std::sin(phi)));
+    }
 
-          float falloff = 1.f - (dist / SFLOAT(ir)); // TODO kernel
-          falloff = std::clamp(falloff, 0.0f, 1.0f);
+  painter.restore();
+}
 
-          this->field.at(fx, fy) += amp * falloff;
-          this->field.at(fx, fy) = std::clamp(this->field.at(fx, fy), 0.0f, 1.0f);
+QRect CanvasField::flood_fill(int   x,
+                              int   y,
+                              float value,
+                              float tolerance,
+                              bool  connectivity8)
+{
+  QRect dirty = qsx::flood_fill(this->field, x, y, value, tolerance, connectivity8);
 
-          this->field_angle.at(fx, fy) = (1.f - falloff) * this->field_angle.at(fx, fy) +
-                                         falloff * angle;
-        }
-      }
+  if (dirty.isValid())
+  {
+    this->field_stats.update(this->field,
+                             dirty.left(),
+                             dirty.top(),
+                             dirty.right(),
+                             dirty.bottom());
+    this->update();
+    Q_EMIT this->value_changed();
   }
 
-  this->update();
-  Q_EMIT this->value_changed();
+  Q_EMIT this->edit_ended();
+  return dirty;
 }
 
 std::vector<float> CanvasField::get_field_data() const
@@ -249,7 +381,32 @@ std::vector<float> CanvasField::get_field_angle_data() const
 
 int CanvasField::get_field_height() const { return this->field.height; }
 
-int CanvasField::get_field_width() const { return this->field.height; }
+PairVec CanvasField::get_field_histogram() const
+{
+  return this->field_stats.get_histogram();
+}
+
+float CanvasField::get_field_max() const { return this->field_stats.get_max(); }
+
+float CanvasField::get_field_mean() const { return this->field_stats.get_mean(); }
+
+float CanvasField::get_field_min() const { return this->field_stats.get_min(); }
+
+int CanvasField::get_field_width() const { return this->field.width; }
+
+std::function<PairVec()> CanvasField::get_histogram_fct()
+{
+  // can be passed to SliderRange::set_histogram_fct, returns an empty
+  // histogram once the canvas has been destroyed
+  QPointer<CanvasField> self(this);
+
+  return [self]()
+  {
+    return self ? self->get_field_histogram() : PairVec();
+  };
+}
+
+SymmetryMode CanvasField::get_symmetry_mode() const { return this->symmetry_mode; }
 
 bool CanvasField::event(QEvent *event)
 {
@@ -331,6 +488,23 @@ void CanvasField::keyPressEvent(QKeyEvent *event)
     this->show_bg_image = !this->show_bg_image;
     this->update();
   }
+  else if (event->key() == Qt::Key_F)
+  {
+    this->tool = this->tool == Tool::FLOOD_FILL ? Tool::BRUSH : Tool::FLOOD_FILL;
+    this->update();
+  }
+  else if (event->key() == Qt::Key_L)
+  {
+    this->tool = this->tool == Tool::LASSO_FILL ? Tool::BRUSH : Tool::LASSO_FILL;
+    this->is_lassoing = false;
+    this->update();
+  }
+  else if (event->key() == Qt::Key_M)
+  {
+    // cycle through the symmetry modes
+    int next = (SINT(this->symmetry_mode) + 1) % (SINT(SymmetryMode::RADIAL) + 1);
+    this->set_symmetry_mode(static_cast<SymmetryMode>(next));
+  }
   else
   {
     QWidget::keyPressEvent(event);
@@ -351,17 +525,61 @@ void CanvasField::keyReleaseEvent(QKeyEvent *event)
   }
 }
 
+QRect CanvasField::lasso_fill(const std::vector<QPointF> &polygon, float value)
+{
+  QRect dirty = fill_polygon(this->field, polygon, value);
+
+  if (dirty.isValid())
+  {
+    this->field_stats.update(this->field,
+                             dirty.left(),
+                             dirty.top(),
+                             dirty.right(),
+                             dirty.bottom());
+    this->update();
+    Q_EMIT this->value_changed();
+  }
+
+  Q_EMIT this->edit_ended();
+  return dirty;
+}
+
 void CanvasField::mouseMoveEvent(QMouseEvent *event)
 {
   if (this->is_drawing)
     this->draw_at(event->buttons());
+  else if (this->is_lassoing)
+  {
+    QPointF pos = event->position() - QPointF(this->rect_img.topLeft());
+    this->lasso_points.push_back(pos);
+    this->update();
+  }
 
   QWidget::mouseMoveEvent(event);
 }
 
 void CanvasField::mousePressEvent(QMouseEvent *event)
 {
-  if (event->button() == Qt::LeftButton || event->button() == Qt::RightButton)
+  const bool is_fill_button = event->button() == Qt::LeftButton ||
+                              event->button() == Qt::RightButton;
+  const float fill_value = event->button() == Qt::LeftButton ? 1.f : 0.f;
+
+  if (is_fill_button && this->tool == Tool::FLOOD_FILL)
+  {
+    QPoint pos = event->position().toPoint() - this->rect_img.topLeft();
+    this->flood_fill(pos.x(),
+                     pos.y(),
+                     fill_value,
+                     QSX_CONFIG->canvas.fill_tolerance,
+                     QSX_CONFIG->canvas.fill_connectivity8);
+  }
+  else if (is_fill_button && this->tool == Tool::LASSO_FILL)
+  {
+    this->is_lassoing = true;
+    this->lasso_value = fill_value;
+    this->lasso_points = {event->position() - QPointF(this->rect_img.topLeft())};
+  }
+  else if (event->button() == Qt::LeftButton || event->button() == Qt::RightButton)
   {
     this->is_drawing = true;
     this->pos_previous = this->mapFromGlobal(QCursor::pos());
@@ -374,8 +592,18 @@ void CanvasField::mousePressEvent(QMouseEvent *event)
 
 void CanvasField::mouseReleaseEvent(QMouseEvent *event)
 {
-  this->is_drawing = false;
-  Q_EMIT this->edit_ended();
+  if (this->is_lassoing)
+  {
+    this->is_lassoing = false;
+    this->lasso_fill(this->lasso_points, this->lasso_value);
+    this->lasso_points.clear();
+  }
+  else if (this->is_drawing)
+  {
+    // whatever the current tool, it may have been switched mid-stroke
+    this->is_drawing = false;
+    Q_EMIT this->edit_ended();
+  }
 
   // no call to the base class event handler to avoid unwanted closing
   // of context menu for instance
@@ -426,6 +654,9 @@ void CanvasField::paintEvent(QPaintEvent *)
     painter.drawImage(this->rect_img, image);
   }
 
+  // symmetry axes
+  this->draw_symmetry_axes(painter);
+
   // main label
   {
     QPen pen;
@@ -446,7 +677,22 @@ void CanvasField::paintEvent(QPaintEvent *)
     pen.setStyle(this->shift_pressed ? Qt::DotLine : Qt::SolidLine);
     painter.setPen(pen);
     painter.setBrush(Qt::NoBrush);
-    painter.drawEllipse(mouse_pos, this->brush_radius, this->brush_radius);
+
+    if (this->tool == Tool::BRUSH)
+      painter.drawEllipse(mouse_pos, this->brush_radius, this->brush_radius);
+    else if (this->tool == Tool::FLOOD_FILL)
+      painter.drawText(this->rect_img, Qt::AlignHCenter | Qt::AlignTop, "FLOOD FILL");
+    else
+      painter.drawText(this->rect_img, Qt::AlignHCenter | Qt::AlignTop, "LASSO FILL");
+
+    // lasso being drawn
+    if (this->is_lassoing && this->lasso_points.size() > 1)
+    {
+      painter.save();
+      painter.translate(this->rect_img.topLeft());
+      painter.drawPolyline(this->lasso_points.data(), SINT(this->lasso_points.size()));
+      painter.restore();
+    }
 
     // labels
     std::string txt = "";
@@ -518,6 +764,7 @@ void CanvasField::set_field_data(const std::vector<float> &new_data)
     // Fast path: no flipping needed
     this->field.data = new_data;
     this->field.data.resize(w * h);
+    this->field_stats.reset(this->field);
     return;
   }
 
@@ -539,6 +786,67 @@ void CanvasField::set_field_data(const std::vector<float> &new_data)
         this->field.data[dst_idx] = 0.0f;
     }
   }
+
+  this->field_stats.reset(this->field);
+}
+
+void CanvasField::set_field_size(int new_width, int new_height, ResampleFilter filter)
+{
+  if (new_width < 1 || new_height < 1)
+    return;
+
+  if (new_width == this->field.width && new_height == this->field.height)
+    return;
+
+  this->field = resample(this->field, new_width, new_height, filter);
+
+  // ringing filters may overshoot
+  for (auto &v : this->field.data)
+    v = std::clamp(v, 0.f, 1.f);
+
+  // angles are periodic, resample their unit vectors instead of the raw
+  // values to avoid artifacts around the wrapping point
+  {
+    FloatField cos_angle(this->field_angle.width, this->field_angle.height);
+    FloatField sin_angle(this->field_angle.width, this->field_angle.height);
+
+    for (size_t k = 0; k < this->field_angle.data.size(); ++k)
+    {
+      float alpha = SFLOAT(M_PI) * (2.f * this->field_angle.data[k] - 1.f);
+      cos_angle.data[k] = std::cos(alpha);
+      sin_angle.data[k] = std::sin(alpha);
+    }
+
+    cos_angle = resample(cos_angle, new_width, new_height, filter);
+    sin_angle = resample(sin_angle, new_width, new_height, filter);
+
+    this->field_angle = FloatField(new_width, new_height);
+
+    for (size_t k = 0; k < this->field_angle.data.size(); ++k)
+    {
+      float alpha = std::atan2(sin_angle.data[k], cos_angle.data[k]);
+      this->field_angle.data[k] = 0.5f * (alpha / SFLOAT(M_PI) + 1.f);
+    }
+  }
+
+  this->field_stats.reset(this->field);
+
+  this->update_geometry();
+
+  Q_EMIT this->value_changed();
+  Q_EMIT this->edit_ended();
+}
+
+void CanvasField::set_radial_symmetry_order(int new_order)
+{
+  this->radial_symmetry_order = std::max(2, new_order);
+  this->update();
+}
+
+void CanvasField::set_symmetry_mode(SymmetryMode new_mode)
+{
+  this->symmetry_mode = new_mode;
+  this->update();
 }
 
 QSize CanvasField::sizeHint() const
@@ -546,6 +854,61 @@ QSize CanvasField::sizeHint() const
   return QSize(this->canvas_width, this->canvas_height);
 }
 
+std::vector<CanvasField::Stamp> CanvasField::symmetric_stamps(const QPoint &pos,
+                                                              float angle) const
+{
+  // angles are stored in [0, 1] == [-pi, pi], wrap them back in this range
+  auto wrap = [](float a) { return a - std::floor(a); };
+
+  const int w = this->field.width;
+  const int h = this->field.height;
+
+  std::vector<Stamp> stamps = {{pos.x(), pos.y(), angle}};
+
+  switch (this->symmetry_mode)
+  {
+  case SymmetryMode::MIRROR_X:
+    stamps.push_back({w - 1 - pos.x(), pos.y(), wrap(1.5f - angle)});
+    break;
+
+  case SymmetryMode::MIRROR_Y:
+    stamps.push_back({pos.x(), h - 1 - pos.y(), wrap(1.f - angle)});
+    break;
+
+  case SymmetryMode::MIRROR_XY:
+    stamps.push_back({w - 1 - pos.x(), pos.y(), wrap(1.5f - angle)});
+    stamps.push_back({pos.x(), h - 1 - pos.y(), wrap(1.f - angle)});
+    stamps.push_back({w - 1 - pos.x(), h - 1 - pos.y(), wrap(angle + 0.5f)});
+    break;
+
+  case SymmetryMode::RADIAL:
+  {
+    float cx = 0.5f * SFLOAT(w - 1);
+    float cy = 0.5f * SFLOAT(h - 1);
+    float dx = SFLOAT(pos.x()) - cx;
+    float dy = SFLOAT(pos.y()) - cy;
+
+    for (int k = 1; k < this->radial_symmetry_order; ++k)
+    {
+      float a = SFLOAT(k) / SFLOAT(this->radial_symmetry_order);
+      float phi = 2.f * SFLOAT(M_PI) * a;
+      float c = std::cos(phi);
+      float s = std::sin(phi);
+
+      stamps.push_back({SINT(std::round(cx + c * dx - s * dy)),
+                        SINT(std::round(cy + s * dx + c * dy)),
+                        wrap(angle + a)});
+    }
+  }
+  break;
+
+  default:
+    break;
+  }
+
+  return stamps;
+}
+
 void CanvasField::update_geometry()
 {
   int gap = QSX_CONFIG->global.radius;
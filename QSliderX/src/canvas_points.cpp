@@ -1,16 +1,25 @@
 /* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
+#include <array>
 #include <format>
+#include <numeric>
 
 #include <QEvent>
 #include <QHoverEvent>
+#include <QKeyEvent>
+#include <QMenu>
 #include <QPainter>
+#include <QPainterPath>
 #include <QtMath>
 
 #include "qsx/canvas_points.hpp"
 #include "qsx/config.hpp"
+#include "qsx/internal/distance_transform.hpp"
 #include "qsx/internal/logger.hpp"
+#include "qsx/internal/point_cloud_io.hpp"
+#include "qsx/internal/poisson_disk.hpp"
+#include "qsx/internal/polyline.hpp"
 #include "qsx/internal/utils.hpp"
 
 namespace qsx
@@ -32,20 +41,162 @@ CanvasPoints::CanvasPoints(const std::string &label_,
   this->setMouseTracking(true);
   this->setAttribute(Qt::WA_Hover);
   this->setContextMenuPolicy(Qt::CustomContextMenu);
+  this->setFocusPolicy(Qt::StrongFocus);
 
   this->update_geometry();
 }
 
+size_t CanvasPoints::EditOp::bytes() const
+{
+  return sizeof(EditOp) + this->ids.size() * sizeof(int) +
+         (this->x.size() + this->y.size() + this->z.size()) * sizeof(float);
+}
+
 void CanvasPoints::add_point(float x, float y)
 {
   this->points_x.push_back(x);
   this->points_y.push_back(y);
   this->points_z.push_back(1.f);
+  this->is_spatial_index_dirty = true;
+  this->is_density_image_dirty = true;
+  this->is_rasterization_dirty = true;
+  this->is_distance_field_dirty = true;
+
+  int idx = SINT(this->points_x.size()) - 1;
+  this->push_history({EditOp::Type::REMOVE, {idx}, {x}, {y}, {1.f}});
+
   this->update();
+  Q_EMIT this->point_inserted(idx);
   Q_EMIT this->value_changed();
 }
 
-void CanvasPoints::canvas_position_to_xy(QPoint pos, float &x, float &y)
+// Applies the operation and turns it into the one reverting it: moves swap
+// the stored and current values, insertions and removals are exchanged.
+void CanvasPoints::apply_edit_op(EditOp &op)
+{
+  const size_t n = op.ids.size();
+
+  switch (op.type)
+  {
+  case EditOp::Type::MOVE:
+    for (size_t k = 0; k < n; ++k)
+    {
+      int idx = op.ids[k];
+      std::swap(this->points_x[idx], op.x[k]);
+      std::swap(this->points_y[idx], op.y[k]);
+      std::swap(this->points_z[idx], op.z[k]);
+    }
+    break;
+
+  case EditOp::Type::INSERT:
+    // increasing ids, each one is its final position
+    for (size_t k = 0; k < n; ++k)
+    {
+      int idx = op.ids[k];
+      this->points_x.insert(this->points_x.begin() + idx, op.x[k]);
+      this->points_y.insert(this->points_y.begin() + idx, op.y[k]);
+      this->points_z.insert(this->points_z.begin() + idx, op.z[k]);
+    }
+    op.type = EditOp::Type::REMOVE;
+    break;
+
+  case EditOp::Type::REMOVE:
+    // decreasing ids, the remaining ones stay valid
+    for (size_t k = n; k-- > 0;)
+    {
+      int idx = op.ids[k];
+      op.x[k] = this->points_x[idx];
+      op.y[k] = this->points_y[idx];
+      op.z[k] = this->points_z[idx];
+      this->points_x.erase(this->points_x.begin() + idx);
+      this->points_y.erase(this->points_y.begin() + idx);
+      this->points_z.erase(this->points_z.begin() + idx);
+    }
+    op.type = EditOp::Type::INSERT;
+    break;
+
+  case EditOp::Type::RESET:
+    std::swap(this->points_x, op.x);
+    std::swap(this->points_y, op.y);
+    std::swap(this->points_z, op.z);
+    break;
+  }
+
+  this->is_density_image_dirty = true;
+
+  // a single moved point only updates its neighborhood
+  if (op.type == EditOp::Type::MOVE && n == 1)
+  {
+    int idx = op.ids[0];
+    this->move_point_in_spatial_index(idx, op.x[0], op.y[0]);
+    this->update_rasterized_point(idx, op.x[0], op.y[0]);
+    this->update_distance_field_point(idx, op.x[0], op.y[0]);
+    return;
+  }
+
+  if (op.type != EditOp::Type::MOVE)
+  {
+    this->selected_ids.clear(); // ids shifted
+    this->hovered_point_id = -1;
+  }
+
+  this->is_spatial_index_dirty = true;
+  this->is_rasterization_dirty = true;
+  this->is_distance_field_dirty = true;
+}
+
+// Applies the transform (scaling and rotation around the selection centroid,
+// then translation) to the selected points positions stored by
+// begin_selection_transform().
+void CanvasPoints::apply_selection_transform(float dx, float dy, float scale, float angle)
+{
+  const size_t n = this->selected_ids.size();
+  const float  c = scale * std::cos(angle);
+  const float  s = scale * std::sin(angle);
+  const float  cx = this->selection_cx;
+  const float  cy = this->selection_cy;
+
+  for (size_t k = 0; k < n; ++k)
+  {
+    float u = this->selection_x_before[k] - cx;
+    float v = this->selection_y_before[k] - cy;
+    int   idx = this->selected_ids[k];
+
+    this->points_x[idx] = std::clamp(cx + c * u - s * v + dx, this->xmin, this->xmax);
+    this->points_y[idx] = std::clamp(cy + s * u + c * v + dy, this->ymin, this->ymax);
+  }
+
+  this->is_spatial_index_dirty = true;
+  this->is_density_image_dirty = true;
+  this->is_rasterization_dirty = true;
+  this->is_distance_field_dirty = true;
+}
+
+void CanvasPoints::begin_selection_transform()
+{
+  const size_t n = this->selected_ids.size();
+
+  this->selection_x_before.resize(n);
+  this->selection_y_before.resize(n);
+  this->selection_cx = 0.f;
+  this->selection_cy = 0.f;
+
+  for (size_t k = 0; k < n; ++k)
+  {
+    this->selection_x_before[k] = this->points_x[this->selected_ids[k]];
+    this->selection_y_before[k] = this->points_y[this->selected_ids[k]];
+    this->selection_cx += this->selection_x_before[k];
+    this->selection_cy += this->selection_y_before[k];
+  }
+
+  if (n > 0)
+  {
+    this->selection_cx /= SFLOAT(n);
+    this->selection_cy /= SFLOAT(n);
+  }
+}
+
+void CanvasPoints::canvas_position_to_xy(QPoint pos, float &x, float &y) const
 {
   pos -= this->rect_points.topLeft();
 
@@ -56,10 +207,200 @@ void CanvasPoints::canvas_position_to_xy(QPoint pos, float &x, float &y)
   y = this->ymin + ry * (this->ymax - this->ymin);
 }
 
+void CanvasPoints::clear_history()
+{
+  this->undo_stack.clear();
+  this->redo_stack.clear();
+  this->history_bytes = 0;
+}
+
+void CanvasPoints::clear_selection()
+{
+  this->selected_ids.clear();
+  this->update();
+}
+
+// Draws the path segments, or the points when they are not connected, into
+// the distance transform seeds. With a valid region (in cells), only the
+// region is cleared and redrawn.
+void CanvasPoints::draw_distance_seeds(const QRect &region)
+{
+  FloatField &seeds = this->distance_seeds;
+  const int   n = SINT(this->points_x.size());
+  const float sx = SFLOAT(seeds.width) / (this->xmax - this->xmin);
+  const float sy = SFLOAT(seeds.height) / (this->ymax - this->ymin);
+  const bool  path = this->connected_points && n >= 2;
+
+  std::vector<int> ids;
+
+  if (region.isValid())
+  {
+    for (int j = region.top(); j <= region.bottom(); ++j)
+      std::fill_n(&seeds.at(region.left(), j), region.width(), 0.f);
+
+    // items overlapping the region, with a one cell margin
+    this->update_spatial_index();
+
+    float x0 = this->xmin + SFLOAT(region.left() - 1) / sx;
+    float y0 = this->ymin + SFLOAT(region.top() - 1) / sy;
+    float x1 = this->xmin + SFLOAT(region.right() + 2) / sx;
+    float y1 = this->ymin + SFLOAT(region.bottom() + 2) / sy;
+
+    (path ? this->segments_grid : this->points_grid).query(x0, y0, x1, y1, ids);
+  }
+  else
+  {
+    ids.resize(static_cast<size_t>(path ? n - 1 : n));
+    std::iota(ids.begin(), ids.end(), 0);
+  }
+
+  for (int k : ids)
+  {
+    float ax = (this->points_x[k] - this->xmin) * sx;
+    float ay = (this->points_y[k] - this->ymin) * sy;
+
+    if (path)
+      draw_segment(seeds,
+                   ax,
+                   ay,
+                   (this->points_x[k + 1] - this->xmin) * sx,
+                   (this->points_y[k + 1] - this->ymin) * sy,
+                   1.f,
+                   region);
+    else
+      draw_segment(seeds, ax, ay, ax, ay, 1.f, region);
+  }
+}
+
+void CanvasPoints::draw_points(QPainter &painter)
+{
+  const int n = SINT(this->points_x.size());
+  const int point_radius = QSX_CONFIG->canvas.point_radius;
+  const int arc_width = QSX_CONFIG->canvas.value_arc_width;
+
+  if (n == 0)
+    return;
+
+  std::vector<QPoint> positions(static_cast<size_t>(n));
+  for (int k = 0; k < n; ++k)
+    positions[k] = this->xy_to_canvas_position(this->points_x[k], this->points_y[k]);
+
+  // connections, single polyline
+  if (this->connected_points && n > 1)
+  {
+    painter.setPen(QPen(QSX_CONFIG->global.color_text, QSX_CONFIG->global.width_border));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawPolyline(positions.data(), n);
+  }
+
+  // points drawn with full detail, either all of them or, for large sets,
+  // only the ones around the cursor on top of a cached density image
+  std::vector<int> ids;
+
+  if (n > QSX_CONFIG->canvas.lod_point_threshold)
+  {
+    if (this->is_density_image_dirty)
+      this->update_density_image();
+
+    painter.drawImage(this->rect_points.topLeft(), this->density_image);
+
+    if (this->is_hovered)
+    {
+      this->update_spatial_index();
+
+      const QPoint mouse_pos = this->mapFromGlobal(QCursor::pos());
+      const int    r = QSX_CONFIG->canvas.lod_detail_radius;
+      float        x0, y0, x1, y1;
+
+      this->canvas_position_to_xy(mouse_pos + QPoint(-r, r), x0, y0);
+      this->canvas_position_to_xy(mouse_pos + QPoint(r, -r), x1, y1);
+      this->points_grid.query(x0, y0, x1, y1, ids);
+    }
+
+    if (this->hovered_point_id >= 0)
+      ids.push_back(this->hovered_point_id);
+
+    ids.insert(ids.end(), this->selected_ids.begin(), this->selected_ids.end());
+
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  }
+  else
+  {
+    ids.resize(static_cast<size_t>(n));
+    std::iota(ids.begin(), ids.end(), 0);
+  }
+
+  // one path per style, the hovered point is drawn last
+  QPainterPath path_values;
+  QPainterPath path_points;
+  QPainterPath path_selected;
+
+  path_values.setFillRule(Qt::WindingFill);
+  path_points.setFillRule(Qt::WindingFill);
+  path_selected.setFillRule(Qt::WindingFill);
+
+  for (int k : ids)
+  {
+    const QPointF pos = positions[k];
+
+    if (this->draw_z_value)
+    {
+      float  lx = SFLOAT(2 * (point_radius + arc_width));
+      QRectF rect_arc = QRectF(pos - QPointF(0.5f * lx, 0.5f * lx), QSizeF(lx, lx));
+      float  alpha = this->points_z[k] * 360.f;
+
+      path_values.moveTo(pos);
+      path_values.arcTo(rect_arc, 90.f - alpha, alpha);
+      path_values.closeSubpath();
+    }
+
+    if (k == this->hovered_point_id)
+      continue;
+
+    if (this->is_point_selected(k))
+      path_selected.addEllipse(pos, point_radius, point_radius);
+    else
+      path_points.addEllipse(pos, point_radius, point_radius);
+  }
+
+  if (this->draw_z_value)
+  {
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QBrush(QSX_CONFIG->global.color_faded));
+    painter.drawPath(path_values);
+  }
+
+  painter.setPen(QPen(QSX_CONFIG->global.color_text, QSX_CONFIG->global.width_border));
+  painter.setBrush(QBrush(QSX_CONFIG->global.color_bg));
+  painter.drawPath(path_points);
+
+  painter.setPen(
+      QPen(QSX_CONFIG->global.color_selected, QSX_CONFIG->global.width_hovered));
+  painter.drawPath(path_selected);
+
+  if (this->hovered_point_id >= 0 && this->hovered_point_id < n)
+  {
+    painter.setBrush(QBrush(QSX_CONFIG->global.color_selected));
+    painter.drawEllipse(positions[this->hovered_point_id], point_radius, point_radius);
+  }
+}
+
+bool CanvasPoints::is_point_selected(int idx) const
+{
+  return std::binary_search(this->selected_ids.begin(), this->selected_ids.end(), idx);
+}
+
 bool CanvasPoints::event(QEvent *event)
 {
   switch (event->type())
   {
+  case QEvent::FontChange:
+  {
+    this->update_geometry();
+  }
+  break;
+
   case QEvent::HoverEnter:
   {
     this->is_hovered = true;
@@ -81,17 +422,7 @@ bool CanvasPoints::event(QEvent *event)
     QPoint mouse_pos = hover->position().toPoint(); // mouse position inside the widget
 
     if (!this->is_dragging)
-    {
-      this->hovered_point_id = -1;
-      int radius = QSX_CONFIG->canvas.point_radius;
-      for (size_t k = 0; k < this->points_x.size(); ++k)
-      {
-        QPoint pos = this->xy_to_canvas_position(this->points_x[k], this->points_y[k]);
-        QRect  prect = QRect(pos - QPoint(radius, radius), QSize(2 * radius, 2 * radius));
-        if (prect.contains(mouse_pos))
-          this->hovered_point_id = SINT(k);
-      }
-    }
+      this->hovered_point_id = this->find_hovered_point(mouse_pos);
 
     this->update();
   }
@@ -104,17 +435,143 @@ bool CanvasPoints::event(QEvent *event)
   return QWidget::event(event);
 }
 
+// Returns the point under the mouse cursor (the last one if several points
+// overlap), or -1.  Only the points stored in the grid cells around the
+// cursor are tested.
+int CanvasPoints::find_hovered_point(const QPoint &mouse_pos)
+{
+  this->update_spatial_index();
+
+  // pixel box around the cursor in data coordinates, with a one pixel margin
+  // to account for rounding
+  const int radius = QSX_CONFIG->canvas.point_radius;
+  float     x0, y0, x1, y1;
+
+  this->canvas_position_to_xy(mouse_pos + QPoint(-radius - 1, radius + 1), x0, y0);
+  this->canvas_position_to_xy(mouse_pos + QPoint(radius + 1, -radius - 1), x1, y1);
+
+  std::vector<int> ids;
+  this->points_grid.query(x0, y0, x1, y1, ids);
+
+  int hovered_id = -1;
+
+  for (int k : ids)
+  {
+    QPoint pos = this->xy_to_canvas_position(this->points_x[k], this->points_y[k]);
+    QRect  prect = QRect(pos - QPoint(radius, radius), QSize(2 * radius, 2 * radius));
+    if (prect.contains(mouse_pos))
+      hovered_id = std::max(hovered_id, k);
+  }
+
+  return hovered_id;
+}
+
+void CanvasPoints::generate_poisson_disk_points(float             radius,
+                                                uint32_t          seed,
+                                                const FloatField &density)
+{
+  std::vector<float> new_x, new_y;
+
+  poisson_disk_sampling(this->xmin,
+                        this->xmax,
+                        this->ymin,
+                        this->ymax,
+                        radius,
+                        new_x,
+                        new_y,
+                        seed,
+                        density);
+
+  std::vector<float> new_z(new_x.size(), 1.f);
+
+  this->replace_points(std::move(new_x), std::move(new_y), std::move(new_z), true);
+  Q_EMIT this->edit_ended();
+}
+
+const FloatField &CanvasPoints::get_distance_field()
+{
+  if (this->is_distance_field_dirty)
+  {
+    this->distance_seeds.clear();
+    this->draw_distance_seeds(QRect());
+    distance_transform(this->distance_seeds, this->distance_field, this->distance_max);
+    this->is_distance_field_dirty = false;
+  }
+
+  return this->distance_field;
+}
+
 std::vector<float> CanvasPoints::get_points_x() const { return this->points_x; }
 
 std::vector<float> CanvasPoints::get_points_y() const { return this->points_y; }
 
 std::vector<float> CanvasPoints::get_points_z() const { return this->points_z; }
 
+std::span<const float> CanvasPoints::get_points_x_span() const
+{
+  return std::span<const float>(this->points_x);
+}
+
+std::span<const float> CanvasPoints::get_points_y_span() const
+{
+  return std::span<const float>(this->points_y);
+}
+
+std::span<const float> CanvasPoints::get_points_z_span() const
+{
+  return std::span<const float>(this->points_z);
+}
+
+const FloatField &CanvasPoints::get_rasterized_points()
+{
+  if (this->is_rasterization_dirty)
+  {
+    this->rasterizer.rasterize(this->points_x, this->points_y, this->points_z);
+    this->is_rasterization_dirty = false;
+  }
+
+  return this->rasterizer.get_field();
+}
+
+std::vector<int> CanvasPoints::get_selection() const { return this->selected_ids; }
+
 std::string CanvasPoints::get_value_as_string(float v) const
 {
   return std::vformat(this->value_format, std::make_format_args(v));
 }
 
+void CanvasPoints::keyPressEvent(QKeyEvent *event)
+{
+  if (event->matches(QKeySequence::Undo))
+    this->undo();
+  else if (event->matches(QKeySequence::Redo))
+    this->redo();
+  else
+    QWidget::keyPressEvent(event);
+}
+
+bool CanvasPoints::load_points_binary(const std::string &fname, int decimation)
+{
+  std::vector<float> new_x, new_y, new_z;
+
+  if (!read_points_binary(fname, new_x, new_y, new_z, decimation))
+    return false;
+
+  this->replace_points(std::move(new_x), std::move(new_y), std::move(new_z), true);
+  return true;
+}
+
+bool CanvasPoints::load_points_csv(const std::string &fname, int decimation)
+{
+  std::vector<float> new_x, new_y, new_z;
+
+  if (!read_points_csv(fname, new_x, new_y, new_z, decimation))
+    return false;
+
+  this->replace_points(std::move(new_x), std::move(new_y), std::move(new_z), true);
+  return true;
+}
+
 void CanvasPoints::mouseDoubleClickEvent(QMouseEvent *event)
 {
   QPoint pos = event->position().toPoint();
@@ -132,8 +589,15 @@ void CanvasPoints::mouseDoubleClickEvent(QMouseEvent *event)
       this->points_x.insert(this->points_x.begin() + idx, x);
       this->points_y.insert(this->points_y.begin() + idx, y);
       this->points_z.insert(this->points_z.begin() + idx, 1.f);
+      this->selected_ids.clear(); // ids shifted
+      this->is_spatial_index_dirty = true;
+      this->is_density_image_dirty = true;
+      this->is_rasterization_dirty = true;
+      this->is_distance_field_dirty = true;
       this->hovered_point_id = idx;
+      this->push_history({EditOp::Type::REMOVE, {idx}, {x}, {y}, {1.f}});
       this->update();
+      Q_EMIT this->point_inserted(idx);
       Q_EMIT this->value_changed();
     }
     else
@@ -152,7 +616,19 @@ void CanvasPoints::mouseDoubleClickEvent(QMouseEvent *event)
 
 void CanvasPoints::mouseMoveEvent(QMouseEvent *event)
 {
-  if (this->is_dragging)
+  if (this->is_selecting)
+  {
+    QPoint pos = event->position().toPoint();
+
+    if (!this->is_lasso_selecting)
+      this->selection_path.resize(1);
+
+    if (pos != this->selection_path.back())
+      this->selection_path.push_back(pos);
+
+    this->update();
+  }
+  else if (this->is_dragging)
   {
     // pixels per unit
     float ppu_x = SFLOAT(this->rect_points.width()) / (this->xmax - this->xmin);
@@ -168,23 +644,45 @@ void CanvasPoints::mouseMoveEvent(QMouseEvent *event)
     float  dvx = SFLOAT(delta.x()) / ppu_x;
     float  dvy = SFLOAT(delta.y()) / ppu_y;
 
-    this->points_x[this->hovered_point_id] = this->value_x_before_dragging + dvx;
-    this->points_y[this->hovered_point_id] = this->value_y_before_dragging - dvy;
-
-    // check bounds
-    this->points_x[this->hovered_point_id] = std::clamp(
-        this->points_x[this->hovered_point_id],
-        this->xmin,
-        this->xmax);
-    this->points_y[this->hovered_point_id] = std::clamp(
-        this->points_y[this->hovered_point_id],
-        this->ymin,
-        this->ymax);
+    if (this->is_dragging_selection)
+    {
+      this->apply_selection_transform(dvx, -dvy, 1.f, 0.f);
+    }
+    else
+    {
+      float x_before = this->points_x[this->hovered_point_id];
+      float y_before = this->points_y[this->hovered_point_id];
+
+      this->points_x[this->hovered_point_id] = this->value_x_before_dragging + dvx;
+      this->points_y[this->hovered_point_id] = this->value_y_before_dragging - dvy;
+
+      // check bounds
+      this->points_x[this->hovered_point_id] = std::clamp(
+          this->points_x[this->hovered_point_id],
+          this->xmin,
+          this->xmax);
+      this->points_y[this->hovered_point_id] = std::clamp(
+          this->points_y[this->hovered_point_id],
+          this->ymin,
+          this->ymax);
+
+      this->move_point_in_spatial_index(this->hovered_point_id, x_before, y_before);
+      this->update_rasterized_point(this->hovered_point_id, x_before, y_before);
+      this->update_distance_field_point(this->hovered_point_id, x_before, y_before);
+      this->is_density_image_dirty = true;
+    }
 
     this->update();
 
     event->accept();
 
+    if (this->is_dragging_selection)
+      Q_EMIT this->points_reset();
+    else
+      Q_EMIT this->point_moved(this->hovered_point_id,
+                               this->points_x[this->hovered_point_id],
+                               this->points_y[this->hovered_point_id]);
+
     Q_EMIT this->value_changed();
   }
 
@@ -195,13 +693,33 @@ void CanvasPoints::mousePressEvent(QMouseEvent *event)
 {
   if (event->button() == Qt::LeftButton)
   {
-    if (this->hovered_point_id >= 0)
+    if (this->hovered_point_id >= 0 && this->selected_ids.size() > 1 &&
+        this->is_point_selected(this->hovered_point_id))
+    {
+      // move the whole selection
+      this->begin_selection_transform();
+      this->mouse_pos_before_dragging = event->position().toPoint();
+      this->is_dragging_selection = true;
+      this->set_is_dragging(true);
+    }
+    else if (this->hovered_point_id >= 0)
     {
       this->value_x_before_dragging = this->points_x[this->hovered_point_id];
       this->value_y_before_dragging = this->points_y[this->hovered_point_id];
       this->mouse_pos_before_dragging = event->position().toPoint();
       this->set_is_dragging(true);
     }
+    else if (event->modifiers() & (Qt::ShiftModifier | Qt::AltModifier))
+    {
+      // SHIFT: rubber-band, ALT: lasso
+      this->is_selecting = true;
+      this->is_lasso_selecting = event->modifiers() & Qt::AltModifier;
+      this->selection_path = {event->position().toPoint()};
+    }
+    else if (!this->selected_ids.empty())
+    {
+      this->clear_selection();
+    }
   }
   else if (event->button() == Qt::RightButton)
   {
@@ -212,6 +730,10 @@ void CanvasPoints::mousePressEvent(QMouseEvent *event)
       this->remove_point(id_to_remove);
       Q_EMIT this->edit_ended();
     }
+    else if (this->connected_points)
+    {
+      this->show_context_menu(); // path edits only
+    }
   }
 
   // no call to the base class event handler to avoid unwanted closing
@@ -220,8 +742,58 @@ void CanvasPoints::mousePressEvent(QMouseEvent *event)
 
 void CanvasPoints::mouseReleaseEvent(QMouseEvent *event)
 {
+  if (this->is_selecting)
+  {
+    // CTRL: add to the current selection
+    bool                 add = event->modifiers() & Qt::ControlModifier;
+    std::vector<QPointF> polygon;
+
+    for (auto &pos : this->selection_path)
+    {
+      float x, y;
+      this->canvas_position_to_xy(pos, x, y);
+      polygon.push_back(QPointF(x, y));
+    }
+
+    if (!this->is_lasso_selecting && polygon.size() == 2)
+      this->select_in_rect(SFLOAT(polygon[0].x()),
+                           SFLOAT(polygon[0].y()),
+                           SFLOAT(polygon[1].x()),
+                           SFLOAT(polygon[1].y()),
+                           add);
+    else if (this->is_lasso_selecting && polygon.size() >= 3)
+      this->select_in_polygon(polygon, add);
+
+    this->is_selecting = false;
+    this->selection_path.clear();
+    this->update();
+  }
+
   if (this->is_dragging)
   {
+    if (this->is_dragging_selection)
+    {
+      EditOp op = {EditOp::Type::MOVE,
+                   this->selected_ids,
+                   this->selection_x_before,
+                   this->selection_y_before};
+
+      for (int idx : this->selected_ids)
+        op.z.push_back(this->points_z[idx]);
+
+      this->push_history(std::move(op));
+    }
+    else if (this->hovered_point_id >= 0)
+    {
+      int idx = this->hovered_point_id;
+      this->push_history({EditOp::Type::MOVE,
+                          {idx},
+                          {this->value_x_before_dragging},
+                          {this->value_y_before_dragging},
+                          {this->points_z[idx]}});
+    }
+
+    this->is_dragging_selection = false;
     this->set_is_dragging(false);
     Q_EMIT this->edit_ended();
   }
@@ -233,7 +805,6 @@ void CanvasPoints::mouseReleaseEvent(QMouseEvent *event)
 void CanvasPoints::paintEvent(QPaintEvent *)
 {
   const int radius = QSX_CONFIG->global.radius;
-  const int point_radius = QSX_CONFIG->canvas.point_radius;
 
   QPainter painter(this);
   painter.setRenderHint(QPainter::Antialiasing);
@@ -260,70 +831,50 @@ void CanvasPoints::paintEvent(QPaintEvent *)
                    this->label.c_str());
 
   // points
-  for (size_t k = 0; k < this->points_x.size(); ++k)
-  {
-    bool toggle = (SINT(k) == this->hovered_point_id);
-
-    QPoint pos = this->xy_to_canvas_position(this->points_x[k], this->points_y[k]);
-
-    // connections
-    if (this->connected_points && k < this->points_x.size() - 1)
-    {
-      painter.setPen(
-          QPen(QSX_CONFIG->global.color_text, QSX_CONFIG->global.width_border));
-      painter.setBrush(Qt::NoBrush);
-
-      QPoint pos_next = this->xy_to_canvas_position(this->points_x[k + 1],
-                                                    this->points_y[k + 1]);
-      painter.drawLine(pos, pos_next);
-    }
-
-    // point value
-    if (this->draw_z_value)
-    {
-      int arc_width = QSX_CONFIG->canvas.value_arc_width;
-
-      painter.setPen(Qt::NoPen);
-      painter.setBrush(QBrush(QSX_CONFIG->global.color_faded));
-
-      QPoint delta = QPoint(-point_radius - arc_width, -point_radius - arc_width);
-      int    lx = 2 * (point_radius + arc_width);
+  this->draw_points(painter);
 
-      int   alpha = SINT(this->points_z[k] * 360.f * 16.f);
-      QRect rect_arc = QRect(pos + delta, QSize(lx, lx));
-      painter.drawPie(rect_arc, 90 * 16 - alpha, alpha);
-    }
-
-    // point itself
-    painter.setPen(QPen(QSX_CONFIG->global.color_text, QSX_CONFIG->global.width_border));
-    painter.setBrush(toggle ? QBrush(QSX_CONFIG->global.color_selected)
-                            : QBrush(QSX_CONFIG->global.color_bg));
+  // selection being drawn
+  if (this->is_selecting && this->selection_path.size() >= 2)
+  {
+    painter.setPen(QPen(QSX_CONFIG->global.color_selected, 1, Qt::DashLine));
+    painter.setBrush(Qt::NoBrush);
 
-    painter.drawEllipse(pos, point_radius, point_radius);
+    if (this->is_lasso_selecting)
+      painter.drawPolygon(this->selection_path.data(),
+                          SINT(this->selection_path.size()));
+    else
+      painter.drawRect(
+          QRect(this->selection_path[0], this->selection_path[1]).normalized());
   }
 
   // display value if dragging
   if (this->hovered_point_id >= 0) // this->is_dragging)
   {
-    painter.setPen(QPen(QSX_CONFIG->global.color_text, QSX_CONFIG->global.width_border));
-
-    std::string sx = this->get_value_as_string(this->points_x[this->hovered_point_id]);
-    std::string sy = this->get_value_as_string(this->points_y[this->hovered_point_id]);
-    std::string sz = this->get_value_as_string(this->points_z[this->hovered_point_id]);
-    std::string txt;
+    const float x = this->points_x[this->hovered_point_id];
+    const float y = this->points_y[this->hovered_point_id];
+    const float z = this->draw_z_value ? this->points_z[this->hovered_point_id] : -1.f;
 
-    if (this->draw_z_value)
-      txt = "(" + sx + ", " + sy + ", " + sz + ")";
-    else
-      txt = "(" + sx + ", " + sy + ")";
+    // only lay the text out again when the displayed values change
+    const std::array<float, 4> key = {SFLOAT(this->hovered_point_id), x, y, z};
 
-    QPoint pos = this->xy_to_canvas_position(this->points_x[this->hovered_point_id],
-                                             this->points_y[this->hovered_point_id]);
+    if (key != this->value_text_key)
+    {
+      std::string txt = "(" + this->get_value_as_string(x) + ", " +
+                        this->get_value_as_string(y);
+      if (this->draw_z_value)
+        txt += ", " + this->get_value_as_string(z);
+      txt += ")";
+
+      this->value_text.setText(txt.c_str());
+      this->value_text.prepare(QTransform(), this->value_font);
+      this->value_text_key = key;
+    }
 
-    resize_font(this, -2);
-    int w = text_width(this, txt);
-    int h = text_height(this);
-    int dy = h + QSX_CONFIG->canvas.point_radius + QSX_CONFIG->canvas.value_arc_width;
+    QPoint pos = this->xy_to_canvas_position(x, y);
+    QSizeF size = this->value_text.size();
+    int    w = SINT(std::ceil(size.width()));
+    int    h = SINT(std::ceil(size.height()));
+    int    dy = h + QSX_CONFIG->canvas.point_radius + QSX_CONFIG->canvas.value_arc_width;
 
     // keep text within the visible rectangle
     QPoint text_pos = pos + QPoint(0, -dy);
@@ -331,12 +882,9 @@ void CanvasPoints::paintEvent(QPaintEvent *)
     if (text_pos.y() <= 0)
       text_pos.setY(pos.y() + dy - h);
 
-    painter.setFont(this->font());
-    painter.drawText(QRect(text_pos, QSize(w, h)),
-                     Qt::AlignLeft | Qt::AlignVCenter,
-                     txt.c_str());
-
-    resize_font(this, 2);
+    painter.setPen(QPen(QSX_CONFIG->global.color_text, QSX_CONFIG->global.width_border));
+    painter.setFont(this->value_font);
+    painter.drawStaticText(text_pos, this->value_text);
     painter.setFont(this->font());
   }
 }
@@ -344,57 +892,269 @@ void CanvasPoints::paintEvent(QPaintEvent *)
 // Returns the index at which a new point (x, y) should be inserted so that it
 // sits on the closest existing edge segment of the path.  Falls back to
 // appending when there are fewer than 2 points.
-int CanvasPoints::find_path_insertion_index(float x, float y) const
+int CanvasPoints::find_path_insertion_index(float x, float y)
 {
   if (this->points_x.size() < 2)
     return SINT(this->points_x.size());
 
-  int   best_idx = 1;
-  float best_dist = std::numeric_limits<float>::max();
+  this->update_spatial_index();
+
+  // search the segments stored around (x, y) within a growing box, a segment
+  // closer than the box half-size necessarily overlaps the box
+  int              best_idx = 1;
+  float            best_dist = std::numeric_limits<float>::max();
+  float            r = std::max(this->segments_grid.get_cell_size(), 1e-6f);
+  std::vector<int> ids;
+
+  while (true)
+  {
+    ids.clear();
+    this->segments_grid.query(x - r, y - r, x + r, y + r, ids);
+
+    for (int k : ids)
+    {
+      float ax = this->points_x[k];
+      float ay = this->points_y[k];
+      float bx = this->points_x[k + 1];
+      float by = this->points_y[k + 1];
+
+      float dx = bx - ax;
+      float dy = by - ay;
+      float len2 = dx * dx + dy * dy;
+
+      float t = (len2 > 0.f)
+                    ? std::clamp(((x - ax) * dx + (y - ay) * dy) / len2, 0.f, 1.f)
+                    : 0.f;
+
+      float ex = ax + t * dx - x;
+      float ey = ay + t * dy - y;
+      float dist = ex * ex + ey * ey;
 
-  for (size_t k = 0; k + 1 < this->points_x.size(); ++k)
+      // ties are resolved with the first segment along the path
+      if (dist < best_dist || (dist == best_dist && k + 1 < best_idx))
+      {
+        best_dist = dist;
+        best_idx = k + 1;
+      }
+    }
+
+    if (best_dist <= r * r || this->segments_grid.query_covers_grid(x - r,
+                                                                     y - r,
+                                                                     x + r,
+                                                                     y + r))
+      break;
+
+    r *= 2.f;
+  }
+
+  return best_idx;
+}
+
+void CanvasPoints::move_point_in_spatial_index(int idx, float x_before, float y_before)
+{
+  // full rebuild pending anyway
+  if (this->is_spatial_index_dirty)
+    return;
+
+  const float x = this->points_x[idx];
+  const float y = this->points_y[idx];
+
+  this->points_grid.remove(idx, x_before, y_before);
+  this->points_grid.insert(idx, x, y);
+
+  if (!this->connected_points)
+    return;
+
+  // segments [idx - 1, idx] and [idx, idx + 1]
+  for (int k : {idx - 1, idx})
   {
+    if (k < 0 || k + 1 >= SINT(this->points_x.size()))
+      continue;
+
+    // segment end points before and after the move
     float ax = this->points_x[k];
     float ay = this->points_y[k];
     float bx = this->points_x[k + 1];
     float by = this->points_y[k + 1];
+    float ax_before = k == idx ? x_before : ax;
+    float ay_before = k == idx ? y_before : ay;
+    float bx_before = k + 1 == idx ? x_before : bx;
+    float by_before = k + 1 == idx ? y_before : by;
+
+    this->segments_grid.remove(k,
+                               std::min(ax_before, bx_before),
+                               std::min(ay_before, by_before),
+                               std::max(ax_before, bx_before),
+                               std::max(ay_before, by_before));
+    this->segments_grid.insert(k,
+                               std::min(ax, bx),
+                               std::min(ay, by),
+                               std::max(ax, bx),
+                               std::max(ay, by));
+  }
+}
 
-    float dx = bx - ax;
-    float dy = by - ay;
-    float len2 = dx * dx + dy * dy;
-
-    float t = (len2 > 0.f) ? std::clamp(((x - ax) * dx + (y - ay) * dy) / len2, 0.f, 1.f)
-                           : 0.f;
-
-    float ex = ax + t * dx - x;
-    float ey = ay + t * dy - y;
-    float dist = ex * ex + ey * ey;
+// Stores the operation reverting an edit, drops the redo history and then
+// the oldest edits beyond the count or memory budget.
+void CanvasPoints::push_history(EditOp &&op)
+{
+  // click without drag
+  if (op.type == EditOp::Type::MOVE)
+  {
+    bool changed = false;
 
-    if (dist < best_dist)
+    for (size_t k = 0; k < op.ids.size() && !changed; ++k)
     {
-      best_dist = dist;
-      best_idx = SINT(k) + 1;
+      int idx = op.ids[k];
+      changed = op.x[k] != this->points_x[idx] || op.y[k] != this->points_y[idx] ||
+                op.z[k] != this->points_z[idx];
     }
+
+    if (!changed)
+      return;
   }
 
-  return best_idx;
+  for (auto &redo_op : this->redo_stack)
+    this->history_bytes -= redo_op.bytes();
+  this->redo_stack.clear();
+
+  this->history_bytes += op.bytes();
+  this->undo_stack.push_back(std::move(op));
+
+  while (!this->undo_stack.empty() &&
+         (this->undo_stack.size() > QSX_CONFIG->global.max_history ||
+          this->history_bytes > QSX_CONFIG->canvas.history_max_bytes))
+  {
+    this->history_bytes -= this->undo_stack.front().bytes();
+    this->undo_stack.pop_front();
+  }
+}
+
+bool CanvasPoints::redo()
+{
+  return this->step_history(this->redo_stack, this->undo_stack);
 }
 
 void CanvasPoints::remove_point(int idx)
 {
+  this->push_history({EditOp::Type::INSERT,
+                      {idx},
+                      {this->points_x[idx]},
+                      {this->points_y[idx]},
+                      {this->points_z[idx]}});
+
   this->points_x.erase(this->points_x.begin() + idx);
   this->points_y.erase(this->points_y.begin() + idx);
   this->points_z.erase(this->points_z.begin() + idx);
+  this->selected_ids.clear(); // ids shifted
+  this->is_spatial_index_dirty = true;
+  this->is_density_image_dirty = true;
+  this->is_rasterization_dirty = true;
+  this->is_distance_field_dirty = true;
   this->update();
+  Q_EMIT this->point_removed(idx);
   Q_EMIT this->value_changed();
 }
 
+void CanvasPoints::resample_path(int n)
+{
+  std::vector<float> new_x, new_y, new_z;
+  resample_arc_length(this->points_x,
+                      this->points_y,
+                      this->points_z,
+                      n,
+                      new_x,
+                      new_y,
+                      new_z);
+  this->replace_points(std::move(new_x), std::move(new_y), std::move(new_z), true);
+}
+
 void CanvasPoints::resizeEvent(QResizeEvent *event)
 {
   this->update_geometry();
   QWidget::resizeEvent(event);
 }
 
+bool CanvasPoints::save_points_binary(const std::string &fname) const
+{
+  return write_points_binary(fname, this->points_x, this->points_y, this->points_z);
+}
+
+bool CanvasPoints::save_points_csv(const std::string &fname) const
+{
+  return write_points_csv(fname, this->points_x, this->points_y, this->points_z);
+}
+
+void CanvasPoints::select_in_polygon(const std::vector<QPointF> &polygon, bool add)
+{
+  if (polygon.size() < 3)
+    return;
+
+  float x0 = std::numeric_limits<float>::max();
+  float y0 = std::numeric_limits<float>::max();
+  float x1 = std::numeric_limits<float>::lowest();
+  float y1 = std::numeric_limits<float>::lowest();
+
+  for (auto &p : polygon)
+  {
+    x0 = std::min(x0, SFLOAT(p.x()));
+    y0 = std::min(y0, SFLOAT(p.y()));
+    x1 = std::max(x1, SFLOAT(p.x()));
+    y1 = std::max(y1, SFLOAT(p.y()));
+  }
+
+  // candidates from the grid, then even-odd rule
+  this->update_spatial_index();
+
+  std::vector<int> ids;
+  this->points_grid.query(x0, y0, x1, y1, ids);
+
+  std::erase_if(ids,
+                [this, &polygon](int k)
+                {
+                  const double x = this->points_x[k];
+                  const double y = this->points_y[k];
+                  bool         inside = false;
+
+                  for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++)
+                  {
+                    const QPointF &a = polygon[i];
+                    const QPointF &b = polygon[j];
+
+                    if ((a.y() > y) != (b.y() > y) &&
+                        x < a.x() + (y - a.y()) * (b.x() - a.x()) / (b.y() - a.y()))
+                      inside = !inside;
+                  }
+
+                  return !inside;
+                });
+
+  this->set_selection(std::move(ids), add);
+}
+
+void CanvasPoints::select_in_rect(float x0, float y0, float x1, float y1, bool add)
+{
+  if (x0 > x1)
+    std::swap(x0, x1);
+  if (y0 > y1)
+    std::swap(y0, y1);
+
+  // grid cells overlapping the rectangle may hold points outside of it
+  this->update_spatial_index();
+
+  std::vector<int> ids;
+  this->points_grid.query(x0, y0, x1, y1, ids);
+
+  std::erase_if(ids,
+                [this, x0, y0, x1, y1](int k)
+                {
+                  return this->points_x[k] < x0 || this->points_x[k] > x1 ||
+                         this->points_y[k] < y0 || this->points_y[k] > y1;
+                });
+
+  this->set_selection(std::move(ids), add);
+}
+
 void CanvasPoints::set_bg_image(const QImage &new_bg_image)
 {
   this->bg_image = new_bg_image.copy();
@@ -405,9 +1165,18 @@ void CanvasPoints::set_bg_image(const QImage &new_bg_image)
 void CanvasPoints::set_connected_points(bool new_state)
 {
   this->connected_points = new_state;
+  this->is_spatial_index_dirty = true;
+  this->is_distance_field_dirty = true;
   this->update();
 }
 
+void CanvasPoints::set_distance_field(int width, int height, float max_distance)
+{
+  this->distance_seeds = FloatField(std::max(width, 0), std::max(height, 0));
+  this->distance_max = max_distance;
+  this->is_distance_field_dirty = true;
+}
+
 void CanvasPoints::set_draw_z_value(bool new_state)
 {
   this->draw_z_value = new_state;
@@ -417,42 +1186,137 @@ void CanvasPoints::set_draw_z_value(bool new_state)
 void CanvasPoints::set_points(const std::vector<float> &new_x,
                               const std::vector<float> &new_y)
 {
-  std::vector<float> new_z(new_x.size(), 1.f);
-  this->set_points(new_x, new_y, new_z);
+  this->set_points(std::vector<float>(new_x),
+                   std::vector<float>(new_y),
+                   std::vector<float>(new_x.size(), 1.f));
 }
 
 void CanvasPoints::set_points(const std::vector<float> &new_x,
                               const std::vector<float> &new_y,
                               const std::vector<float> &new_z)
 {
-  this->points_x = new_x;
-  this->points_y = new_y;
-  this->points_z = new_z;
+  this->set_points(std::vector<float>(new_x),
+                   std::vector<float>(new_y),
+                   std::vector<float>(new_z));
+}
+
+void CanvasPoints::set_points(std::vector<float> &&new_x,
+                              std::vector<float> &&new_y,
+                              std::vector<float> &&new_z)
+{
+  this->replace_points(std::move(new_x), std::move(new_y), std::move(new_z), false);
+}
+
+// Bulk edit, the previous arrays are moved into the history (as a single
+// operation) or the history is cleared.
+void CanvasPoints::replace_points(std::vector<float> &&new_x,
+                                  std::vector<float> &&new_y,
+                                  std::vector<float> &&new_z,
+                                  bool                record_history)
+{
+  if (record_history)
+    this->push_history({EditOp::Type::RESET,
+                        {},
+                        std::move(this->points_x),
+                        std::move(this->points_y),
+                        std::move(this->points_z)});
+  else
+    this->clear_history();
+
+  this->points_x = std::move(new_x);
+  this->points_y = std::move(new_y);
+  this->points_z = std::move(new_z);
+
+  if (this->hovered_point_id >= SINT(this->points_x.size()))
+    this->hovered_point_id = -1;
+
+  this->selected_ids.clear();
+
+  this->is_spatial_index_dirty = true;
+  this->is_density_image_dirty = true;
+  this->is_rasterization_dirty = true;
+  this->is_distance_field_dirty = true;
   this->update();
+  Q_EMIT this->points_reset();
   Q_EMIT this->value_changed();
 }
 
 void CanvasPoints::set_points_x(const std::vector<float> &new_x)
 {
-  this->points_x = new_x;
+  this->set_points_x(std::vector<float>(new_x));
+}
+
+void CanvasPoints::set_points_x(std::vector<float> &&new_x)
+{
+  this->clear_history();
+  this->points_x = std::move(new_x);
+  this->selected_ids.clear();
+  this->is_spatial_index_dirty = true;
+  this->is_density_image_dirty = true;
+  this->is_rasterization_dirty = true;
+  this->is_distance_field_dirty = true;
   this->update();
+  Q_EMIT this->points_reset();
   Q_EMIT this->value_changed();
 }
 
 void CanvasPoints::set_points_y(const std::vector<float> &new_y)
 {
-  this->points_y = new_y;
+  this->set_points_y(std::vector<float>(new_y));
+}
+
+void CanvasPoints::set_points_y(std::vector<float> &&new_y)
+{
+  this->clear_history();
+  this->points_y = std::move(new_y);
+  this->selected_ids.clear();
+  this->is_spatial_index_dirty = true;
+  this->is_density_image_dirty = true;
+  this->is_rasterization_dirty = true;
+  this->is_distance_field_dirty = true;
   this->update();
+  Q_EMIT this->points_reset();
   Q_EMIT this->value_changed();
 }
 
 void CanvasPoints::set_points_z(const std::vector<float> &new_z)
 {
-  this->points_z = new_z;
+  this->set_points_z(std::vector<float>(new_z));
+}
+
+void CanvasPoints::set_points_z(std::vector<float> &&new_z)
+{
+  this->clear_history();
+  this->points_z = std::move(new_z);
+  this->is_rasterization_dirty = true;
   this->update();
+  Q_EMIT this->points_reset();
   Q_EMIT this->value_changed();
 }
 
+void CanvasPoints::set_rasterization(int                 width,
+                                     int                 height,
+                                     PointsRasterization method,
+                                     float               radius)
+{
+  this->rasterizer.set_domain(this->xmin, this->xmax, this->ymin, this->ymax);
+  this->rasterizer.set_method(method, radius);
+  this->rasterizer.set_size(width, height);
+  this->is_rasterization_dirty = true;
+}
+
+void CanvasPoints::set_selection(std::vector<int> &&ids, bool add)
+{
+  if (add)
+    ids.insert(ids.end(), this->selected_ids.begin(), this->selected_ids.end());
+
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+  this->selected_ids = std::move(ids);
+  this->update();
+}
+
 void CanvasPoints::set_is_dragging(bool new_state)
 {
   this->is_dragging = new_state;
@@ -468,6 +1332,241 @@ QSize CanvasPoints::sizeHint() const
   return QSize(this->canvas_width, this->canvas_height);
 }
 
+// Scales and rotates (angle in radians) the selection around its centroid,
+// then translates it, as one complete edit.
+void CanvasPoints::transform_selection(float dx, float dy, float scale, float angle)
+{
+  if (this->selected_ids.empty())
+    return;
+
+  this->begin_selection_transform();
+  this->apply_selection_transform(dx, dy, scale, angle);
+
+  EditOp op = {EditOp::Type::MOVE,
+               this->selected_ids,
+               this->selection_x_before,
+               this->selection_y_before};
+
+  for (int idx : this->selected_ids)
+    op.z.push_back(this->points_z[idx]);
+
+  this->push_history(std::move(op));
+  this->update();
+
+  Q_EMIT this->points_reset();
+  Q_EMIT this->value_changed();
+  Q_EMIT this->edit_ended();
+}
+
+bool CanvasPoints::undo()
+{
+  return this->step_history(this->undo_stack, this->redo_stack);
+}
+
+void CanvasPoints::show_context_menu()
+{
+  const int  n = SINT(this->points_x.size());
+  const bool is_path = n >= 3; // only shown in connected mode
+
+  QMenu menu(this);
+
+  QAction *rdp_action = menu.addAction("Simplify path (Ramer-Douglas-Peucker)");
+  QAction *vw_action = menu.addAction("Simplify path (Visvalingam-Whyatt)");
+  QAction *resample_action = menu.addAction("Resample path");
+
+  rdp_action->setEnabled(is_path);
+  vw_action->setEnabled(is_path);
+  resample_action->setEnabled(is_path);
+
+  QAction *selected = menu.exec(QCursor::pos());
+
+  if (selected)
+  {
+    float diagonal = std::hypot(this->xmax - this->xmin, this->ymax - this->ymin);
+    float tolerance = QSX_CONFIG->canvas.path_simplify_tolerance * diagonal;
+
+    if (selected == rdp_action)
+      this->simplify_path(tolerance, RAMER_DOUGLAS_PEUCKER);
+    else if (selected == vw_action)
+      this->simplify_path(tolerance, VISVALINGAM_WHYATT);
+    else if (selected == resample_action)
+      this->resample_path(n); // same count, even spacing
+
+    Q_EMIT this->edit_ended();
+  }
+}
+
+// Tolerance is a distance for Ramer-Douglas-Peucker and the side of the square
+// with the same area for Visvalingam-Whyatt.
+void CanvasPoints::simplify_path(float tolerance, PathSimplification method)
+{
+  std::vector<int> ids = method == VISVALINGAM_WHYATT
+                             ? simplify_visvalingam(this->points_x,
+                                                    this->points_y,
+                                                    tolerance * tolerance)
+                             : simplify_rdp(this->points_x, this->points_y, tolerance);
+
+  if (ids.size() == this->points_x.size())
+    return;
+
+  std::vector<float> new_x(ids.size()), new_y(ids.size()), new_z(ids.size());
+
+  for (size_t k = 0; k < ids.size(); ++k)
+  {
+    new_x[k] = this->points_x[ids[k]];
+    new_y[k] = this->points_y[ids[k]];
+    new_z[k] = this->points_z[ids[k]];
+  }
+
+  this->replace_points(std::move(new_x), std::move(new_y), std::move(new_z), true);
+}
+
+// Applies the last operation of 'from' and stores its inverse in 'to'.
+bool CanvasPoints::step_history(std::deque<EditOp> &from, std::deque<EditOp> &to)
+{
+  if (from.empty() || this->is_dragging)
+    return false;
+
+  EditOp op = std::move(from.back());
+  from.pop_back();
+
+  // a reset changes the size of the stored arrays
+  this->history_bytes -= op.bytes();
+  this->apply_edit_op(op);
+  this->history_bytes += op.bytes();
+
+  const EditOp::Type type = op.type;
+  const int          idx = op.ids.size() == 1 ? op.ids[0] : -1;
+
+  to.push_back(std::move(op));
+  this->update();
+
+  // 'type' is now the inverse of the applied operation
+  if (idx >= 0 && type == EditOp::Type::MOVE)
+    Q_EMIT this->point_moved(idx, this->points_x[idx], this->points_y[idx]);
+  else if (idx >= 0 && type == EditOp::Type::REMOVE)
+    Q_EMIT this->point_inserted(idx);
+  else if (idx >= 0 && type == EditOp::Type::INSERT)
+    Q_EMIT this->point_removed(idx);
+  else
+    Q_EMIT this->points_reset();
+
+  Q_EMIT this->value_changed();
+  Q_EMIT this->edit_ended();
+  return true;
+}
+
+void CanvasPoints::update_density_image()
+{
+  const int w = this->rect_points.width();
+  const int h = this->rect_points.height();
+
+  this->is_density_image_dirty = false;
+
+  if (w <= 0 || h <= 0)
+  {
+    this->density_image = QImage();
+    return;
+  }
+
+  // splat the points with a 3x3 tent kernel
+  std::vector<float> density(static_cast<size_t>(w * h), 0.f);
+  const float        kernel[3] = {0.5f, 1.f, 0.5f};
+
+  for (size_t k = 0; k < this->points_x.size(); ++k)
+  {
+    QPoint pos = this->xy_to_canvas_position(this->points_x[k], this->points_y[k]) -
+                 this->rect_points.topLeft();
+
+    for (int r = -1; r <= 1; ++r)
+      for (int q = -1; q <= 1; ++q)
+      {
+        int i = pos.x() + q;
+        int j = pos.y() + r;
+        if (i >= 0 && j >= 0 && i < w && j < h)
+          density[static_cast<size_t>(j * w + i)] += kernel[q + 1] * kernel[r + 1];
+      }
+  }
+
+  // saturating density to alpha
+  const QColor color = QSX_CONFIG->global.color_text;
+
+  this->density_image = QImage(w, h, QImage::Format_ARGB32_Premultiplied);
+
+  for (int j = 0; j < h; ++j)
+  {
+    QRgb *line = reinterpret_cast<QRgb *>(this->density_image.scanLine(j));
+
+    for (int i = 0; i < w; ++i)
+    {
+      float a = 1.f - std::exp(-density[static_cast<size_t>(j * w + i)]);
+      line[i] = qRgba(SINT(SFLOAT(color.red()) * a),
+                      SINT(SFLOAT(color.green()) * a),
+                      SINT(SFLOAT(color.blue()) * a),
+                      SINT(255.f * a));
+    }
+  }
+}
+
+// With a clamped distance, a point move only changes the seeds around the
+// segments attached to the point and the distances within 'distance_max'
+// of them.
+void CanvasPoints::update_distance_field_point(int idx, float x_before, float y_before)
+{
+  if (this->is_distance_field_dirty)
+    return;
+
+  if (this->distance_max <= 0.f)
+  {
+    this->is_distance_field_dirty = true;
+    return;
+  }
+
+  const FloatField &seeds = this->distance_seeds;
+  const float       sx = SFLOAT(seeds.width) / (this->xmax - this->xmin);
+  const float       sy = SFLOAT(seeds.height) / (this->ymax - this->ymin);
+  const int         n = SINT(this->points_x.size());
+
+  // bounding box, in cells, of the point before and after the move and of
+  // its neighbors along the path
+  std::vector<QPointF> positions = {QPointF(x_before, y_before),
+                                    QPointF(this->points_x[idx], this->points_y[idx])};
+
+  if (this->connected_points)
+    for (int k : {idx - 1, idx + 1})
+      if (k >= 0 && k < n)
+        positions.push_back(QPointF(this->points_x[k], this->points_y[k]));
+
+  int i0 = seeds.width;
+  int j0 = seeds.height;
+  int i1 = -1;
+  int j1 = -1;
+
+  for (auto &p : positions)
+  {
+    int i = SINT(std::floor((SFLOAT(p.x()) - this->xmin) * sx));
+    int j = SINT(std::floor((SFLOAT(p.y()) - this->ymin) * sy));
+    i0 = std::min(i0, i);
+    j0 = std::min(j0, j);
+    i1 = std::max(i1, i);
+    j1 = std::max(j1, j);
+  }
+
+  QRect region = QRect(QPoint(i0 - 1, j0 - 1), QPoint(i1 + 1, j1 + 1)) &
+                 QRect(0, 0, seeds.width, seeds.height);
+
+  if (region.isEmpty())
+    return;
+
+  this->draw_distance_seeds(region);
+
+  const int margin = SINT(std::ceil(this->distance_max));
+  distance_transform(this->distance_seeds,
+                     this->distance_field,
+                     this->distance_max,
+                     region.adjusted(-margin, -margin, margin, margin));
+}
+
 void CanvasPoints::update_geometry()
 {
   QFontMetrics fm(this->font());
@@ -507,9 +1606,59 @@ void CanvasPoints::update_geometry()
   this->rect_points = this->rect();
   this->rect_label = QRect(QPoint(this->base_dx, 0),
                            QSize(this->rect().width() - this->base_dx, this->base_dy));
+
+  // hovered point values font, text laid out again at next paint
+  this->value_font = this->font();
+  this->value_font.setPointSize(this->value_font.pointSize() - 2);
+  this->value_text.setTextFormat(Qt::PlainText);
+  this->value_text_key = {-1.f, 0.f, 0.f, 0.f};
+
+  this->is_density_image_dirty = true;
 }
 
-QPoint CanvasPoints::xy_to_canvas_position(float x, float y)
+// Recomputes the rasterized field around a moved point, only when the field
+// is up to date, otherwise the full rasterization is pending anyway.
+void CanvasPoints::update_rasterized_point(int idx, float x_before, float y_before)
+{
+  if (this->is_rasterization_dirty)
+    return;
+
+  this->rasterizer.update_point(this->points_x,
+                                this->points_y,
+                                this->points_z,
+                                idx,
+                                x_before,
+                                y_before);
+}
+
+void CanvasPoints::update_spatial_index()
+{
+  if (!this->is_spatial_index_dirty)
+    return;
+
+  // roughly two points per cell
+  const int n = SINT(this->points_x.size());
+  const int nc = std::clamp(SINT(std::sqrt(0.5f * SFLOAT(n))), 1, 256);
+
+  this->points_grid.reset(this->xmin, this->xmax, this->ymin, this->ymax, nc, nc);
+
+  for (int k = 0; k < n; ++k)
+    this->points_grid.insert(k, this->points_x[k], this->points_y[k]);
+
+  this->segments_grid.reset(this->xmin, this->xmax, this->ymin, this->ymax, nc, nc);
+
+  if (this->connected_points)
+    for (int k = 0; k + 1 < n; ++k)
+      this->segments_grid.insert(k,
+                                 std::min(this->points_x[k], this->points_x[k + 1]),
+                                 std::min(this->points_y[k], this->points_y[k + 1]),
+                                 std::max(this->points_x[k], this->points_x[k + 1]),
+                                 std::max(this->points_y[k], this->points_y[k + 1]));
+
+  this->is_spatial_index_dirty = false;
+}
+
+QPoint CanvasPoints::xy_to_canvas_position(float x, float y) const
 {
   float range_x = this->xmax - this->xmin;
   float range_y = this->ymax - this->ymin;
@@ -532,17 +1681,47 @@ void CanvasPoints::wheelEvent(QWheelEvent *event)
       diff /= QSX_CONFIG->canvas.wheel_multiplier_fine_tuning;
 
     float delta = event->angleDelta().y() > 0 ? diff : -diff;
+    float z_before = this->points_z[this->hovered_point_id];
+
     this->points_z[this->hovered_point_id] += delta;
     this->points_z[this->hovered_point_id] = std::clamp(
         this->points_z[this->hovered_point_id],
         0.f,
         1.f);
 
+    this->update_rasterized_point(this->hovered_point_id,
+                                  this->points_x[this->hovered_point_id],
+                                  this->points_y[this->hovered_point_id]);
+
+    this->push_history({EditOp::Type::MOVE,
+                        {this->hovered_point_id},
+                        {this->points_x[this->hovered_point_id]},
+                        {this->points_y[this->hovered_point_id]},
+                        {z_before}});
     this->update();
 
+    Q_EMIT this->point_moved(this->hovered_point_id,
+                             this->points_x[this->hovered_point_id],
+                             this->points_y[this->hovered_point_id]);
     Q_EMIT this->value_changed();
     Q_EMIT this->edit_ended();
   }
+  else if (!this->selected_ids.empty() && !this->is_dragging)
+  {
+    // scale, or rotate with SHIFT, the selection around its centroid
+    float sign = event->angleDelta().y() > 0 ? 1.f : -1.f;
+
+    if (event->modifiers() & Qt::ShiftModifier)
+    {
+      float angle = qDegreesToRadians(QSX_CONFIG->canvas.selection_rotation_step);
+      this->transform_selection(0.f, 0.f, 1.f, sign * angle);
+    }
+    else
+    {
+      float scale = 1.f + sign * QSX_CONFIG->canvas.selection_scale_step;
+      this->transform_selection(0.f, 0.f, scale, 0.f);
+    }
+  }
 }
 
 } // namespace qsx
@@ -3,30 +3,185 @@
  * this software. */
 #include <algorithm>
 #include <cmath>
+#include <stdexcept>
 
 #include <QPainterPath>
 
 #include "qsx/config.hpp"
 #include "qsx/curve_editor.hpp"
+#include "qsx/internal/histogram.hpp"
 #include "qsx/internal/logger.hpp"
+#include "qsx/internal/parallel.hpp"
 #include "qsx/internal/utils.hpp"
 
 namespace qsx
 {
 
+// Maps the 'n' values of 'in', interleaved with 'K' channels ('k' when K is 0,
+// not known at compile time), through the interleaved table 'lut' ('m'
+// entries). A flat loop with a compile-time channel count and non-aliased
+// table and output pointers is the shape GCC vectorizes (gathers for the table
+// reads) with -O3 and -fno-trapping-math, see QSliderX/CMakeLists.txt. 'in' may
+// alias 'out' when applied in place, each value is read before being written.
+template <int K>
+static void apply_table_block(const float *in,
+                              float *__restrict out,
+                              const float *__restrict lut,
+                              int m,
+                              int k,
+                              int n)
+{
+  const int   nc = K > 0 ? K : k;
+  const float scale = SFLOAT(m - 1);
+
+  // branch-free lookup and lerp, NaN mapped to the first entry
+  for (int i = 0; i < n; ++i)
+  {
+    const int c = i % nc;
+
+    float t = std::min(std::max(0.f, in[i]), 1.f) * scale;
+    int   q = std::min(SINT(t), m - 2);
+    float f = t - SFLOAT(q);
+    float v0 = lut[q * nc + c];
+    float v1 = lut[(q + 1) * nc + c];
+
+    out[i] = v0 + f * (v1 - v0);
+  }
+}
+
+// Maps interleaved values with 'k' channels through the interleaved table
+// 'lut' (k values per entry), by blocks of pixels split across threads.
+static void apply_table(const std::vector<float> &lut,
+                        int                       k,
+                        std::span<const float>    in,
+                        std::span<float>          out)
+{
+  const size_t npixels = std::min(in.size(), out.size()) / static_cast<size_t>(k);
+  const int    m = SINT(lut.size()) / k;
+
+  if (m < 2)
+    return;
+
+  // blocks of pixels, the index stays an int whatever the buffer size
+  constexpr size_t block = 1 << 14;
+  const int        nblocks = SINT((npixels + block - 1) / block);
+
+  auto fct = [&](int b0, int b1)
+  {
+    for (int b = b0; b < b1; ++b)
+    {
+      const size_t p0 = static_cast<size_t>(b) * block;
+      const size_t offset = p0 * static_cast<size_t>(k);
+      const int    n = SINT(std::min(block, npixels - p0)) * k;
+
+      const float *in_b = in.data() + offset;
+      float       *out_b = out.data() + offset;
+
+      // the usual layouts get their own vectorized loop
+      switch (k)
+      {
+      case 1:
+        apply_table_block<1>(in_b, out_b, lut.data(), m, k, n);
+        break;
+
+      case 3:
+        apply_table_block<3>(in_b, out_b, lut.data(), m, k, n);
+        break;
+
+      case 4:
+        apply_table_block<4>(in_b, out_b, lut.data(), m, k, n);
+        break;
+
+      default:
+        apply_table_block<0>(in_b, out_b, lut.data(), m, k, n);
+      }
+    }
+  };
+
+  // not worth waking the workers up
+  if (nblocks <= 1)
+    fct(0, nblocks);
+  else
+    parallel_for(0, nblocks, fct);
+}
+
 CurveEditor::CurveEditor(const std::string &label_, int sample_count_, QWidget *parent)
     : QWidget(parent), label(label_), sample_count(sample_count_)
 {
   this->setMouseTracking(true);
   this->setAttribute(Qt::WA_Hover);
 
-  this->clear_points();
+  this->set_channels(CHANNELS_SINGLE);
+}
+
+CurveEditor::~CurveEditor() { this->stop_histogram_worker(); }
+
+void CurveEditor::apply(std::span<const float> in,
+                        std::span<float>       out,
+                        int                    channel) const
+{
+  if (channel >= 0 && channel < SINT(this->channels.size()))
+    apply_table(this->channels[channel].lut, 1, in, out);
+}
+
+void CurveEditor::apply_interleaved(std::span<const float> in, std::span<float> out) const
+{
+  // color channels, the master one is already composed into them
+  const int k = this->channels.size() == 1 ? 1 : SINT(this->channels.size()) - 1;
+
+  apply_table(this->lut_interleaved, k, in, out);
+}
+
+std::vector<float> CurveEditor::bake_lut(int n, int channel) const
+{
+  std::vector<float> lut_values(std::max(n, 1));
+
+  if (channel >= 0 && channel < SINT(this->channels.size()))
+    this->sample_curve(this->channels[channel], lut_values, 0.f, 1.f);
+
+  return lut_values;
+}
+
+std::vector<float> CurveEditor::bake_lut_interleaved(int n) const
+{
+  if (this->channels.size() == 1)
+    return this->bake_lut(n);
+
+  n = std::max(n, 1);
+
+  const int          k = SINT(this->channels.size()) - 1; // color channels
+  std::vector<float> lut_values(static_cast<size_t>(n * k));
+  std::vector<float> samples(n);
+
+  for (int c = 0; c < k; ++c)
+  {
+    const bool is_alpha = c == 3;
+
+    this->sample_curve(this->channels[c + 1], samples, 0.f, 1.f);
+
+    for (int i = 0; i < n; ++i)
+      lut_values[i * k + c] = is_alpha ? samples[i]
+                                       : this->evaluate(this->channels[0], samples[i]);
+  }
+
+  return lut_values;
+}
+
+void CurveEditor::clear_histogram()
+{
+  this->stop_histogram_worker();
+  ++this->histogram_generation;
+
+  this->histogram.clear();
+  this->histogram_pixmap = QPixmap();
+  this->update();
 }
 
 void CurveEditor::clear_points()
 {
-  this->control_points.clear();
-  this->control_points = {{0.f, 0.f}, {1.f, 1.f}};
+  Channel &ch = this->channels[this->active_channel];
+
+  ch.control_points = {{0.f, 0.f}, {1.f, 1.f}};
   this->update_values();
 }
 
@@ -53,33 +208,42 @@ void CurveEditor::draw_background(QPainter &painter)
 
 void CurveEditor::draw_curve(QPainter &painter)
 {
-  painter.setPen(QPen(QSX_CONFIG->global.color_border));
   painter.setBrush(Qt::NoBrush);
 
-  QPainterPath path;
-  QPointF      p0 = this->point_to_screen(this->control_points.front());
-  path.moveTo(p0);
-
-  // lines
-  for (int k = 1; k < this->sample_count; ++k)
+  // cached, rebuilt only after an edit or a resize, the other channels are
+  // overlaid faded below the active one
+  for (int c = 0; c < SINT(this->channels.size()); ++c)
   {
-    float   t = SFLOAT(k) / SFLOAT(this->sample_count - 1);
-    float   y = this->interpolate(t);
-    QPointF p = this->point_to_screen(QPointF(t, y));
-    path.lineTo(p);
+    Channel &ch = this->channels[c];
+
+    if (ch.is_curve_path_dirty)
+      this->update_curve_path(ch);
+
+    if (c != this->active_channel)
+    {
+      QColor color = ch.color;
+      color.setAlphaF(QSX_CONFIG->curve.inactive_channel_alpha);
+      painter.setPen(QPen(color));
+      painter.drawPath(ch.curve_path);
+    }
   }
-  painter.drawPath(path);
 
-  // sampling points
+  const Channel &ch = this->channels[this->active_channel];
+
+  painter.setPen(QPen(ch.color));
+  painter.drawPath(ch.curve_path);
+
+  // sampling points overlay, cached samples
   if (QSX_CONFIG->curve.draw_sampling_points)
   {
-    painter.setBrush(QBrush(QSX_CONFIG->global.color_border));
+    const int n = SINT(ch.values.size());
 
-    for (int k = 0; k < this->sample_count; ++k)
+    painter.setBrush(QBrush(ch.color));
+
+    for (int k = 0; k < n; ++k)
     {
-      float   t = SFLOAT(k) / SFLOAT(this->sample_count - 1);
-      float   y = this->interpolate(t);
-      QPointF p = this->point_to_screen(QPointF(t, y));
+      float   t = SFLOAT(k) / SFLOAT(n - 1);
+      QPointF p = this->point_to_screen(QPointF(t, ch.values[k]));
       painter.drawEllipse(p,
                           QSX_CONFIG->curve.sampling_point_radius,
                           QSX_CONFIG->curve.sampling_point_radius);
@@ -87,12 +251,27 @@ void CurveEditor::draw_curve(QPainter &painter)
   }
 }
 
+void CurveEditor::draw_histogram(QPainter &painter)
+{
+  if (this->histogram.empty())
+    return;
+
+  // cached, the bins themselves are only computed by the worker
+  if (this->is_histogram_pixmap_dirty)
+    this->update_histogram_pixmap();
+
+  const int padding = QSX_CONFIG->global.padding;
+
+  if (!this->histogram_pixmap.isNull())
+    painter.drawPixmap(padding, padding, this->histogram_pixmap);
+}
+
 void CurveEditor::draw_points(QPainter &painter)
 {
   painter.setPen(QPen(QSX_CONFIG->global.color_text, QSX_CONFIG->global.width_border));
   painter.setBrush(QSX_CONFIG->global.color_bg);
 
-  for (auto &p : this->control_points)
+  for (auto &p : this->channels[this->active_channel].control_points)
   {
     QPointF screen_p = this->point_to_screen(p);
     painter.drawEllipse(screen_p,
@@ -101,10 +280,35 @@ void CurveEditor::draw_points(QPainter &painter)
   }
 }
 
+void CurveEditor::draw_tabs(QPainter &painter)
+{
+  const int radius = QSX_CONFIG->global.radius;
+
+  for (int c = 0; c < SINT(this->rect_tabs.size()); ++c)
+  {
+    const Channel &ch = this->channels[c];
+    const bool     is_active = c == this->active_channel;
+
+    painter.setPen(QPen(ch.color, QSX_CONFIG->global.width_border));
+    painter.setBrush(is_active ? QBrush(QSX_CONFIG->global.color_selected)
+                               : QBrush(QSX_CONFIG->global.color_bg));
+    painter.drawRoundedRect(this->rect_tabs[c], radius, radius);
+
+    painter.setPen(QPen(QSX_CONFIG->global.color_text));
+    painter.drawText(this->rect_tabs[c], Qt::AlignCenter, ch.name.c_str());
+  }
+}
+
 bool CurveEditor::event(QEvent *event)
 {
   switch (event->type())
   {
+  case QEvent::FontChange:
+  {
+    this->update_tab_rects();
+  }
+  break;
+
   case QEvent::HoverEnter:
   {
     this->is_hovered = true;
@@ -126,104 +330,93 @@ bool CurveEditor::event(QEvent *event)
   return QWidget::event(event);
 }
 
+float CurveEditor::evaluate(const Channel &ch, float t) const
+{
+  float v = ch.interpolator ? ch.interpolator->interpolate(t) : ch.curve.evaluate(t);
+  return ch.clamp_values ? std::clamp(v, 0.f, 1.f) : v;
+}
+
 int CurveEditor::find_nearest_point(const QPoint &pos) const
 {
-  const float radius = SFLOAT(QSX_CONFIG->global.radius);
+  const float                 radius = SFLOAT(QSX_CONFIG->global.radius);
+  const std::vector<QPointF> &cp = this->channels[this->active_channel].control_points;
 
-  for (int i = 0; i < SINT(this->control_points.size()); ++i)
+  for (int i = 0; i < SINT(cp.size()); ++i)
   {
-    QPointF screen_p = this->point_to_screen(this->control_points[i]);
+    QPointF screen_p = this->point_to_screen(cp[i]);
     if (QLineF(screen_p, pos).length() < 2 * radius)
       return i;
   }
   return -1;
 }
 
-int CurveEditor::get_sample_count() const { return SINT(this->values.size()); }
+int CurveEditor::get_active_channel() const { return this->active_channel; }
 
-bool CurveEditor::get_smooth_interpolation() const { return this->smooth_interpolation; }
+int CurveEditor::get_channel_count() const { return SINT(this->channels.size()); }
 
-std::vector<float> CurveEditor::get_values() const { return this->values; }
+CurveChannels CurveEditor::get_channels() const { return this->channels_mode; }
 
-float CurveEditor::interpolate(float t) const
+int CurveEditor::get_sample_count() const
 {
-  if (this->smooth_interpolation)
-    return this->interpolate_catmull_rom(t);
-  else
-    return this->interpolate_linear(t);
+  return SINT(this->channels.front().values.size());
 }
 
-float CurveEditor::interpolate_catmull_rom(float t) const
+std::optional<InterpolationMethod1D> CurveEditor::get_interpolation_method() const
 {
-  if (this->control_points.empty())
-    return 0.f;
-  if (t <= this->control_points.front().x())
-    return SFLOAT(this->control_points.front().y());
-  if (t >= this->control_points.back().x())
-    return SFLOAT(this->control_points.back().y());
+  return this->interpolation_method;
+}
 
-  // Find segment
-  int segment = -1;
-  for (int i = 0; i < int(this->control_points.size()) - 1; ++i)
-  {
-    if (t >= this->control_points[i].x() && t <= this->control_points[i + 1].x())
-    {
-      segment = i;
-      break;
-    }
-  }
-  if (segment < 0)
-    return SFLOAT(this->control_points.back().y());
+bool CurveEditor::get_smooth_interpolation() const { return this->smooth_interpolation; }
 
-  // Get control points p0, p1, p2, p3 for Catmull-Rom
-  auto p0 = this->control_points[std::max(0, segment - 1)];
-  auto p1 = this->control_points[segment];
-  auto p2 = this->control_points[segment + 1];
-  auto p3 = this->control_points[std::min(segment + 2,
-                                          int(this->control_points.size()) - 1)];
+std::vector<float> CurveEditor::get_values(int channel) const
+{
+  if (channel < 0 || channel >= SINT(this->channels.size()))
+    return {};
 
-  // Normalize local parameter u in [0, 1]
-  float u = SFLOAT((t - p1.x()) / (p2.x() - p1.x()));
-  u = std::clamp(u, 0.0f, 1.0f);
+  return this->channels[channel].values;
+}
 
-  // Catmull–Rom spline formula
-  float u2 = u * u;
-  float u3 = u2 * u;
+// Evaluates the samples, evenly spaced over [0, 1], with an abscissa in
+// [x0, x1].
+void CurveEditor::sample_curve(const Channel   &ch,
+                               std::span<float> samples,
+                               float            x0,
+                               float            x1) const
+{
+  const int   n = SINT(samples.size());
+  const float scale = SFLOAT(std::max(n - 1, 1));
+  const int   i0 = std::clamp(SINT(std::floor(x0 * scale)), 0, n);
+  const int   i1 = std::clamp(SINT(std::ceil(x1 * scale)) + 1, i0, n);
 
-  float y = SFLOAT(0.5f * ((2.0f * p1.y()) + (-p0.y() + p2.y()) * u +
-                           (2.0f * p0.y() - 5.0f * p1.y() + 4.0f * p2.y() - p3.y()) * u2 +
-                           (-p0.y() + 3.0f * p1.y() - 3.0f * p2.y() + p3.y()) * u3));
+  std::vector<float> t(i1 - i0);
+  for (int i = i0; i < i1; ++i)
+    t[i - i0] = SFLOAT(i) / scale;
 
-  return std::clamp(y, 0.0f, 1.0f); // clamp for safety
-}
+  std::span<float> out = samples.subspan(i0, i1 - i0);
 
-float CurveEditor::interpolate_linear(float t) const
-{
-  // linear interpolation between nearest control points
-  if (this->control_points.empty())
-    return 0.0f;
-  if (t <= this->control_points.front().x())
-    return SFLOAT(this->control_points.front().y());
-  if (t >= this->control_points.back().x())
-    return SFLOAT(this->control_points.back().y());
+  if (ch.interpolator)
+    ch.interpolator->evaluate(t, out);
+  else
+    ch.curve.evaluate_sorted(t, out);
 
-  for (size_t i = 0; i < this->control_points.size() - 1; ++i)
-  {
-    auto &p0 = this->control_points[i];
-    auto &p1 = this->control_points[i + 1];
-    if (t >= p0.x() && t <= p1.x())
-    {
-      float u = SFLOAT((t - p0.x()) / (p1.x() - p0.x()));
-      return SFLOAT(p0.y() * (1 - u) + p1.y() * u);
-    }
-  }
-  return 0.0f;
+  if (ch.clamp_values)
+    for (float &v : out)
+      v = std::clamp(v, 0.f, 1.f);
 }
 
 void CurveEditor::mousePressEvent(QMouseEvent *event)
 {
+  std::vector<QPointF> &cp = this->channels[this->active_channel].control_points;
+
   if (event->button() == Qt::LeftButton)
   {
+    for (int c = 0; c < SINT(this->rect_tabs.size()); ++c)
+      if (this->rect_tabs[c].contains(event->pos()))
+      {
+        this->set_active_channel(c);
+        return;
+      }
+
     int idx = this->find_nearest_point(event->pos());
     if (idx >= 0)
     {
@@ -233,10 +426,11 @@ void CurveEditor::mousePressEvent(QMouseEvent *event)
     else
     {
       QPointF new_point = this->screen_to_point(event->pos());
-      this->control_points.push_back(new_point);
-      std::sort(this->control_points.begin(),
-                this->control_points.end(),
-                [](auto &a, auto &b) { return a.x() < b.x(); });
+      auto    it = std::upper_bound(cp.begin(),
+                                 cp.end(),
+                                 new_point,
+                                 [](auto &a, auto &b) { return a.x() < b.x(); });
+      cp.insert(it, new_point);
       this->update_values();
     }
   }
@@ -244,8 +438,8 @@ void CurveEditor::mousePressEvent(QMouseEvent *event)
   {
     int idx = this->find_nearest_point(event->pos());
     // do not allow removal of first and last control points
-    if (idx > 0 && idx < SINT(this->control_points.size()) - 1)
-      this->control_points.erase(this->control_points.begin() + idx);
+    if (idx > 0 && idx < SINT(cp.size()) - 1)
+      cp.erase(cp.begin() + idx);
     this->update_values();
   }
 }
@@ -254,28 +448,40 @@ void CurveEditor::mouseMoveEvent(QMouseEvent *event)
 {
   if (this->is_dragging && this->active_point >= 0)
   {
-    QPointF new_pos = this->screen_to_point(event->pos());
-
-    // prevent "x" modification for first and last control points
-    if (this->active_point == 0 ||
-        this->active_point == SINT(this->control_points.size()) - 1)
-      new_pos.setX(this->control_points[this->active_point].x());
-
-    this->control_points[this->active_point] = new_pos;
+    auto     &cp = this->channels[this->active_channel].control_points;
+    const int n = SINT(cp.size());
+    int       k = this->active_point;
+    QPointF   new_pos = this->screen_to_point(event->pos());
+
+    // prevent "x" modification for first and last control points, the
+    // others stay in between
+    if (k == 0 || k == n - 1)
+      new_pos.setX(cp[k].x());
+    else
+      new_pos.setX(std::clamp(new_pos.x(), cp.front().x(), cp.back().x()));
 
-    std::sort(this->control_points.begin(),
-              this->control_points.end(),
-              [](auto &a, auto &b) { return a.x() < b.x(); });
+    cp[k] = new_pos;
 
-    // update active point index after sorting
-    auto it = std::find_if(this->control_points.begin(),
-                           this->control_points.end(),
-                           [new_pos](auto &p)
-                           { return p.x() == new_pos.x() && p.y() == new_pos.y(); });
+    // restore the order by swaps with the neighbors, the active index
+    // follows the point
+    const int k_before = k;
 
-    this->active_point = SINT(std::distance(this->control_points.begin(), it));
+    if (k > 0 && k < n - 1)
+    {
+      while (k > 1 && cp[k - 1].x() > cp[k].x())
+      {
+        std::swap(cp[k - 1], cp[k]);
+        --k;
+      }
+      while (k < n - 2 && cp[k + 1].x() < cp[k].x())
+      {
+        std::swap(cp[k + 1], cp[k]);
+        ++k;
+      }
+    }
 
-    this->update_values();
+    this->active_point = k;
+    this->update_values(std::min(k, k_before), std::max(k, k_before));
   }
 }
 
@@ -309,6 +515,8 @@ void CurveEditor::paintEvent(QPaintEvent *)
     painter.drawText(rect_label, Qt::AlignLeft | Qt::AlignVCenter, this->label.c_str());
   }
 
+  this->draw_histogram(painter);
+  this->draw_tabs(painter);
   this->draw_curve(painter);
   this->draw_points(painter);
 }
@@ -324,6 +532,16 @@ QPointF CurveEditor::point_to_screen(const QPointF &p) const
   return QPointF(pf + SFLOAT(p.x()) * wf, pf + (1.f - SFLOAT(p.y())) * hf);
 }
 
+void CurveEditor::resizeEvent(QResizeEvent *event)
+{
+  for (auto &ch : this->channels)
+    ch.is_curve_path_dirty = true;
+
+  this->is_histogram_pixmap_dirty = true;
+  this->update_tab_rects();
+  QWidget::resizeEvent(event);
+}
+
 QPointF CurveEditor::screen_to_point(const QPoint &p) const
 {
   const int padding = QSX_CONFIG->global.padding;
@@ -334,11 +552,73 @@ QPointF CurveEditor::screen_to_point(const QPoint &p) const
                  std::clamp(1.f - SFLOAT(p.y() - padding) / hf, 0.f, 1.f));
 }
 
-void CurveEditor::set_control_points(const std::vector<QPointF> &new_control_points)
+void CurveEditor::set_active_channel(int new_channel)
 {
-  this->control_points = new_control_points;
-  this->update_values();
+  if (new_channel < 0 || new_channel >= SINT(this->channels.size()))
+    return;
+
+  this->active_channel = new_channel;
+  this->is_dragging = false;
+  this->active_point = -1;
   this->update();
+}
+
+void CurveEditor::set_channels(CurveChannels new_channels)
+{
+  struct ChannelDesc
+  {
+    const char *name;
+    QColor      color;
+  };
+
+  std::vector<ChannelDesc> descs = {{"RGB", QSX_CONFIG->global.color_border}};
+
+  if (new_channels != CHANNELS_SINGLE)
+  {
+    descs.push_back({"R", QSX_CONFIG->curve.color_red});
+    descs.push_back({"G", QSX_CONFIG->curve.color_green});
+    descs.push_back({"B", QSX_CONFIG->curve.color_blue});
+  }
+
+  if (new_channels == CHANNELS_RGBA)
+    descs.push_back({"A", QSX_CONFIG->curve.color_alpha});
+
+  this->channels_mode = new_channels;
+  this->channels.clear();
+  this->channels.resize(descs.size());
+
+  for (size_t c = 0; c < descs.size(); ++c)
+  {
+    this->channels[c].name = descs[c].name;
+    this->channels[c].color = descs[c].color;
+    this->channels[c].control_points = {{0.f, 0.f}, {1.f, 1.f}};
+  }
+
+  this->active_channel = 0;
+  this->is_dragging = false;
+  this->active_point = -1;
+
+  this->update_tab_rects();
+  this->update_all_channels();
+}
+
+void CurveEditor::set_control_points(const std::vector<QPointF> &new_control_points,
+                                     int                         channel)
+{
+  if (channel < 0 || channel >= SINT(this->channels.size()))
+    return;
+
+  Channel &ch = this->channels[channel];
+
+  ch.control_points = new_control_points;
+  std::stable_sort(ch.control_points.begin(),
+                   ch.control_points.end(),
+                   [](auto &a, auto &b) { return a.x() < b.x(); });
+
+  this->update_channel(ch);
+  this->update_interleaved_lut();
+  this->update();
+  Q_EMIT this->value_changed();
 
   Q_EMIT this->edit_ended();
 }
@@ -346,16 +626,58 @@ void CurveEditor::set_control_points(const std::vector<QPointF> &new_control_poi
 void CurveEditor::set_sample_count(int new_sample_count)
 {
   this->sample_count = new_sample_count;
-  this->update_values();
-  this->update();
+  this->update_all_channels();
 
   Q_EMIT this->edit_ended();
 }
 
+// The bins are computed on a worker thread and handed back to the GUI thread
+// through a queued call, a newer request (or clearing the histogram) cancels
+// the running one and drops its result if it was already posted.
+void CurveEditor::set_histogram_data(std::span<const float> data)
+{
+  this->stop_histogram_worker();
+
+  const int generation = ++this->histogram_generation;
+  const int nbins = std::max(QSX_CONFIG->curve.histogram_bins, 1);
+
+  this->histogram_worker = std::thread(
+      [this, data, nbins, generation]()
+      {
+        std::vector<uint64_t> bins = compute_histogram(data,
+                                                       nbins,
+                                                       this->histogram_cancel);
+        if (this->histogram_cancel)
+          return;
+
+        QMetaObject::invokeMethod(
+            this,
+            [this, bins = std::move(bins), generation]() mutable
+            {
+              if (generation != this->histogram_generation)
+                return;
+
+              this->histogram = std::move(bins);
+              this->is_histogram_pixmap_dirty = true;
+              this->update();
+              Q_EMIT this->histogram_ready();
+            },
+            Qt::QueuedConnection);
+      });
+}
+
+void CurveEditor::set_interpolation_method(
+    std::optional<InterpolationMethod1D> new_method)
+{
+  this->interpolation_method = new_method;
+  this->update_all_channels();
+  Q_EMIT this->edit_ended();
+}
+
 void CurveEditor::set_smooth_interpolation(bool new_state)
 {
   this->smooth_interpolation = new_state;
-  this->update_values();
+  this->update_all_channels();
   Q_EMIT this->edit_ended();
 }
 
@@ -365,14 +687,308 @@ QSize CurveEditor::sizeHint() const
           SINT(0.5f * SFLOAT(QSX_CONFIG->global.width_min))};
 }
 
-void CurveEditor::update_values()
+void CurveEditor::stop_histogram_worker()
+{
+  if (!this->histogram_worker.joinable())
+    return;
+
+  this->histogram_cancel = true;
+  this->histogram_worker.join();
+  this->histogram_cancel = false;
+}
+
+void CurveEditor::update_all_channels()
+{
+  for (auto &ch : this->channels)
+    this->update_channel(ch);
+
+  this->update_interleaved_lut();
+  this->update();
+  Q_EMIT this->value_changed();
+}
+
+// With a valid [first, last] range (same point count, only these points
+// moved), only the segments and the samples depending on them are updated,
+// except for the GSL splines which are global.
+void CurveEditor::update_channel(Channel &ch, int first, int last)
+{
+  const int n = SINT(ch.control_points.size());
+  const int lut_size = std::max(QSX_CONFIG->curve.lut_size, 2);
+
+  bool is_local = !this->interpolation_method && first >= 0 && first <= last &&
+                  last < n && !ch.curve.is_empty() &&
+                  SINT(ch.values.size()) == this->sample_count &&
+                  SINT(ch.lut.size()) == lut_size;
+
+  if (!is_local)
+  {
+    this->update_curve(ch);
+
+    ch.values.assign(std::max(this->sample_count, 1), 0.f);
+    ch.lut.assign(lut_size, 0.f);
+
+    this->sample_curve(ch, ch.values, 0.f, 1.f);
+    this->sample_curve(ch, ch.lut, 0.f, 1.f);
+  }
+  else
+  {
+    std::vector<float> x, y;
+
+    for (int k = first; k <= last; ++k)
+    {
+      x.push_back(SFLOAT(ch.control_points[k].x()));
+      y.push_back(SFLOAT(ch.control_points[k].y()));
+    }
+
+    ch.curve.move_knots(first, x, y);
+
+    // abscissa range of the updated segments (up to two knots away for the
+    // Catmull-Rom tangents), the end values also set the extrapolation
+    float x0 = first >= 2 ? SFLOAT(ch.control_points[first - 2].x()) : 0.f;
+    float x1 = last + 2 < n ? SFLOAT(ch.control_points[last + 2].x()) : 1.f;
+
+    this->sample_curve(ch, ch.values, x0, x1);
+    this->sample_curve(ch, ch.lut, x0, x1);
+  }
+
+  ch.is_curve_path_dirty = true;
+}
+
+// Rebuilds the segment coefficients from the (sorted) control points.
+void CurveEditor::update_curve(Channel &ch)
 {
-  this->values.resize(this->sample_count);
-  for (int i = 0; i < this->sample_count; ++i)
+  const size_t       n = ch.control_points.size();
+  std::vector<float> x(n), y(n);
+
+  for (size_t k = 0; k < n; ++k)
   {
-    float t = float(i) / SFLOAT(this->sample_count - 1);
-    this->values[i] = this->interpolate(t);
+    x[k] = SFLOAT(ch.control_points[k].x());
+    y[k] = SFLOAT(ch.control_points[k].y());
   }
+
+  const bool was_falling_back = ch.is_falling_back;
+
+  ch.interpolator.reset();
+  ch.is_falling_back = false;
+
+  if (this->interpolation_method)
+  {
+    // spline built once here, then only evaluated, in single precision when
+    // the method allows it
+    try
+    {
+      ch.interpolator = std::make_unique<Interpolator1D>(x,
+                                                         y,
+                                                         *this->interpolation_method,
+                                                         ENGINE_NATIVE);
+      ch.clamp_values = *this->interpolation_method != InterpolationMethod1D::LINEAR;
+      return;
+    }
+    catch (const std::invalid_argument &e)
+    {
+      // only once, not for each drag step
+      if (!was_falling_back)
+        Logger::log()->warn("CurveEditor::update_curve: {}, falling back to "
+                            "linear interpolation",
+                            e.what());
+    }
+
+    ch.curve.set_linear(x, y);
+    ch.is_falling_back = true;
+    ch.clamp_values = false;
+  }
+  else if (this->smooth_interpolation)
+  {
+    ch.curve.set_catmull_rom(x, y);
+    ch.clamp_values = true; // overshoot
+  }
+  else
+  {
+    ch.curve.set_linear(x, y);
+    ch.clamp_values = false;
+  }
+}
+
+// Adaptive subdivision in screen space, independent of the sample count:
+// each interval between consecutive control points is split while the curve
+// point at its middle is farther than the flatness tolerance from the chord
+// middle.
+void CurveEditor::update_curve_path(Channel &ch)
+{
+  constexpr int min_depth = 2; // do not miss the symmetric bumps
+  constexpr int max_depth = 12;
+
+  const float tol = QSX_CONFIG->curve.flatness_tolerance;
+  const float tol2 = tol * tol;
+
+  auto to_screen = [this, &ch](float t)
+  { return this->point_to_screen(QPointF(t, this->evaluate(ch, t))); };
+
+  // interval bounds
+  std::vector<float> ts = {0.f, 1.f};
+  for (auto &p : ch.control_points)
+    ts.push_back(std::clamp(SFLOAT(p.x()), 0.f, 1.f));
+
+  std::sort(ts.begin(), ts.end());
+  ts.erase(std::unique(ts.begin(), ts.end()), ts.end());
+
+  struct Interval
+  {
+    float   t0;
+    float   t1;
+    QPointF p0;
+    QPointF p1;
+    int     depth;
+  };
+
+  std::vector<Interval> stack;
+
+  ch.curve_path = QPainterPath();
+  ch.curve_path.moveTo(to_screen(ts.front()));
+
+  for (size_t k = 0; k + 1 < ts.size(); ++k)
+  {
+    stack.push_back({ts[k], ts[k + 1], to_screen(ts[k]), to_screen(ts[k + 1]), 0});
+
+    // left halves are processed first, the points come out in order
+    while (!stack.empty())
+    {
+      Interval iv = stack.back();
+      stack.pop_back();
+
+      float   tm = 0.5f * (iv.t0 + iv.t1);
+      QPointF pm = to_screen(tm);
+      QPointF e = pm - 0.5f * (iv.p0 + iv.p1);
+
+      if (iv.depth < min_depth ||
+          (iv.depth < max_depth && SFLOAT(QPointF::dotProduct(e, e)) > tol2))
+      {
+        stack.push_back({tm, iv.t1, pm, iv.p1, iv.depth + 1});
+        stack.push_back({iv.t0, tm, iv.p0, pm, iv.depth + 1});
+      }
+      else
+        ch.curve_path.lineTo(iv.p1);
+    }
+  }
+
+  ch.is_curve_path_dirty = false;
+}
+
+// Bins drawn as a filled step outline over the bounding box, heights relative
+// to the largest bin.
+void CurveEditor::update_histogram_pixmap()
+{
+  const int padding = QSX_CONFIG->global.padding;
+  const int w = this->width() - 2 * padding;
+  const int h = this->height() - 2 * padding;
+
+  this->is_histogram_pixmap_dirty = false;
+  this->histogram_pixmap = QPixmap();
+
+  if (this->histogram.empty() || w <= 0 || h <= 0)
+    return;
+
+  const uint64_t hmax = *std::max_element(this->histogram.begin(), this->histogram.end());
+  const int      n = SINT(this->histogram.size());
+
+  this->histogram_pixmap = QPixmap(w, h);
+  this->histogram_pixmap.fill(Qt::transparent);
+
+  if (hmax == 0)
+    return;
+
+  QPainterPath path;
+  path.moveTo(QPointF(0.f, SFLOAT(h)));
+
+  for (int k = 0; k < n; ++k)
+  {
+    float x0 = SFLOAT(w) * SFLOAT(k) / SFLOAT(n);
+    float x1 = SFLOAT(w) * SFLOAT(k + 1) / SFLOAT(n);
+    float y = SFLOAT(h) * (1.f - SFLOAT(this->histogram[k]) / SFLOAT(hmax));
+
+    path.lineTo(QPointF(x0, y));
+    path.lineTo(QPointF(x1, y));
+  }
+
+  path.lineTo(QPointF(SFLOAT(w), SFLOAT(h)));
+  path.closeSubpath();
+
+  QPainter painter(&this->histogram_pixmap);
+  painter.setRenderHint(QPainter::Antialiasing, true);
+  painter.setPen(Qt::NoPen);
+  painter.setBrush(QBrush(QSX_CONFIG->curve.color_histogram));
+  painter.drawPath(path);
+}
+
+// Table used by apply_interleaved(), the color channels composed with the
+// master one (alpha excluded), from their own tables.
+void CurveEditor::update_interleaved_lut()
+{
+  const Channel &master = this->channels.front();
+
+  if (this->channels.size() == 1)
+  {
+    this->lut_interleaved = master.lut;
+    return;
+  }
+
+  const int   k = SINT(this->channels.size()) - 1;
+  const int   m = SINT(master.lut.size());
+  const float scale = SFLOAT(m - 1);
+
+  this->lut_interleaved.resize(static_cast<size_t>(m * k));
+
+  for (int c = 0; c < k; ++c)
+  {
+    const std::vector<float> &lut_c = this->channels[c + 1].lut;
+    const bool                is_alpha = c == 3;
+
+    for (int i = 0; i < m; ++i)
+    {
+      float v = lut_c[i];
+
+      if (!is_alpha)
+      {
+        float t = std::clamp(v, 0.f, 1.f) * scale;
+        int   q = std::min(SINT(t), m - 2);
+        float f = t - SFLOAT(q);
+        v = master.lut[q] + f * (master.lut[q + 1] - master.lut[q]);
+      }
+
+      this->lut_interleaved[i * k + c] = v;
+    }
+  }
+}
+
+// Channel tabs in the top right corner, none for a single curve.
+void CurveEditor::update_tab_rects()
+{
+  this->rect_tabs.clear();
+
+  if (this->channels.size() < 2)
+    return;
+
+  const int    padding = QSX_CONFIG->global.padding;
+  QFontMetrics fm(this->font());
+  int          height = fm.height() + padding;
+  int          x = this->width() - 2 * padding;
+
+  this->rect_tabs.resize(this->channels.size());
+
+  for (int c = SINT(this->channels.size()) - 1; c >= 0; --c)
+  {
+    int width = text_width(this, this->channels[c].name) + 2 * padding;
+
+    x -= width;
+    this->rect_tabs[c] = QRect(x, 2 * padding, width, height);
+    x -= padding;
+  }
+}
+
+void CurveEditor::update_values(int first, int last)
+{
+  this->update_channel(this->channels[this->active_channel], first, last);
+  this->update_interleaved_lut();
   this->update();
   Q_EMIT this->value_changed();
 }
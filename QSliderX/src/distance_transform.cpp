@@ -0,0 +1,177 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <cmath>
+
+#include "qsx/internal/distance_transform.hpp"
+#include "qsx/internal/parallel.hpp"
+#include "qsx/internal/utils.hpp"
+
+namespace qsx
+{
+
+static constexpr float EDT_INF = 1e20f;
+
+// 1D squared distance transform of the sampled function f (lower envelope of
+// parabolas), v and z are work buffers of size n and n + 1
+static void edt_1d(const float *f, int n, float *d, int *v, float *z)
+{
+  int k = 0;
+  v[0] = 0;
+  z[0] = -EDT_INF;
+  z[1] = EDT_INF;
+
+  // z[0] = -inf always stops the backtracking since |s| < inf / 2
+  for (int q = 1; q < n; ++q)
+  {
+    float s;
+    while (true)
+    {
+      const float p = SFLOAT(v[k]);
+      s = ((f[q] + SFLOAT(q * q)) - (f[v[k]] + p * p)) / (2.f * SFLOAT(q) - 2.f * p);
+      if (s > z[k])
+        break;
+      --k;
+    }
+
+    ++k;
+    v[k] = q;
+    z[k] = s;
+    z[k + 1] = EDT_INF;
+  }
+
+  k = 0;
+  for (int q = 0; q < n; ++q)
+  {
+    while (z[k + 1] < SFLOAT(q))
+      ++k;
+    const float dq = SFLOAT(q - v[k]);
+    d[q] = dq * dq + f[v[k]];
+  }
+}
+
+void distance_transform(const FloatField &seeds,
+                        FloatField       &distance,
+                        float             max_distance,
+                        const QRect      &region)
+{
+  const QRect full = QRect(0, 0, seeds.width, seeds.height);
+
+  if (distance.width != seeds.width || distance.height != seeds.height)
+    distance = FloatField(seeds.width, seeds.height);
+
+  if (full.isEmpty())
+    return;
+
+  // cells to compute and seeds window they depend on
+  QRect out = full;
+  QRect window = full;
+
+  if (region.isValid() && max_distance > 0.f)
+  {
+    const int margin = SINT(std::ceil(max_distance));
+
+    out = region & full;
+    window = out.adjusted(-margin, -margin, margin, margin) & full;
+
+    if (out.isEmpty())
+      return;
+  }
+
+  const int ww = window.width();
+  const int wh = window.height();
+  const int x0 = window.left();
+  const int y0 = window.top();
+
+  // vertical pass, squared distances along the columns, processed by blocks
+  // of columns to read and write whole row segments
+  constexpr int      block = 16;
+  std::vector<float> g(static_cast<size_t>(ww * wh));
+
+  parallel_for(
+      0,
+      ww,
+      [&](int i0, int i1)
+      {
+        std::vector<float> fb(static_cast<size_t>(wh * block));
+        std::vector<float> db(static_cast<size_t>(wh * block));
+        std::vector<float> f(static_cast<size_t>(wh));
+        std::vector<float> d(static_cast<size_t>(wh));
+        std::vector<int>   v(static_cast<size_t>(wh));
+        std::vector<float> z(static_cast<size_t>(wh + 1));
+
+        for (int ib = i0; ib < i1; ib += block)
+        {
+          const int nb = std::min(block, i1 - ib);
+
+          for (int j = 0; j < wh; ++j)
+            for (int c = 0; c < nb; ++c)
+              fb[j * block + c] = seeds.at(x0 + ib + c, y0 + j) != 0.f ? 0.f : EDT_INF;
+
+          for (int c = 0; c < nb; ++c)
+          {
+            for (int j = 0; j < wh; ++j)
+              f[j] = fb[j * block + c];
+
+            edt_1d(f.data(), wh, d.data(), v.data(), z.data());
+
+            for (int j = 0; j < wh; ++j)
+              db[j * block + c] = d[j];
+          }
+
+          for (int j = 0; j < wh; ++j)
+            std::copy_n(&db[j * block], nb, &g[static_cast<size_t>(j * ww + ib)]);
+        }
+      },
+      block);
+
+  // horizontal pass, only the output rows
+  const float dmax = max_distance > 0.f ? max_distance : EDT_INF;
+
+  parallel_for(out.top(),
+               out.bottom() + 1,
+               [&](int j0, int j1)
+               {
+                 std::vector<float> d(static_cast<size_t>(ww));
+                 std::vector<int>   v(static_cast<size_t>(ww));
+                 std::vector<float> z(static_cast<size_t>(ww + 1));
+
+                 for (int j = j0; j < j1; ++j)
+                 {
+                   const float *f = &g[static_cast<size_t>((j - y0) * ww)];
+
+                   edt_1d(f, ww, d.data(), v.data(), z.data());
+
+                   for (int i = out.left(); i <= out.right(); ++i)
+                     distance.at(i, j) = std::min(std::sqrt(d[i - x0]), dmax);
+                 }
+               });
+}
+
+void draw_segment(FloatField  &field,
+                  float        x0,
+                  float        y0,
+                  float        x1,
+                  float        y1,
+                  float        value,
+                  const QRect &clip)
+{
+  const QRect rect = clip.isValid() ? clip & QRect(0, 0, field.width, field.height)
+                                    : QRect(0, 0, field.width, field.height);
+
+  // at least two samples per crossed cell
+  const int n = SINT(std::ceil(2.f * std::max(std::abs(x1 - x0), std::abs(y1 - y0))));
+
+  for (int k = 0; k <= n; ++k)
+  {
+    float t = n > 0 ? SFLOAT(k) / SFLOAT(n) : 0.f;
+    int   i = SINT(std::floor(x0 + t * (x1 - x0)));
+    int   j = SINT(std::floor(y0 + t * (y1 - y0)));
+
+    if (rect.contains(QPoint(i, j)))
+      field.at(i, j) = value;
+  }
+}
+
+} // namespace qsx
@@ -0,0 +1,143 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+
+#include "qsx/internal/field_stats.hpp"
+#include "qsx/internal/utils.hpp"
+
+namespace qsx
+{
+
+FieldStats::FieldStats(int nbins_, int tile_size_)
+    : nbins(std::max(1, nbins_)), tile_size(std::max(1, tile_size_))
+{
+}
+
+float FieldStats::get_max() const
+{
+  float vmax = 0.f;
+  for (size_t k = 0; k < this->tiles.size(); ++k)
+    vmax = k ? std::max(vmax, this->tiles[k].max) : this->tiles[k].max;
+  return vmax;
+}
+
+float FieldStats::get_mean() const
+{
+  size_t count = static_cast<size_t>(this->width * this->height);
+  return count ? SFLOAT(this->sum / static_cast<double>(count)) : 0.f;
+}
+
+float FieldStats::get_min() const
+{
+  float vmin = 0.f;
+  for (size_t k = 0; k < this->tiles.size(); ++k)
+    vmin = k ? std::min(vmin, this->tiles[k].min) : this->tiles[k].min;
+  return vmin;
+}
+
+int FieldStats::get_nbins() const { return this->nbins; }
+
+std::pair<std::vector<float>, std::vector<float>> FieldStats::get_histogram() const
+{
+  std::pair<std::vector<float>, std::vector<float>> bins;
+  bins.first.resize(this->nbins);
+  bins.second.resize(this->nbins);
+
+  for (int k = 0; k < this->nbins; ++k)
+  {
+    bins.first[k] = (SFLOAT(k) + 0.5f) / SFLOAT(this->nbins);
+    bins.second[k] = SFLOAT(this->hist[k]);
+  }
+
+  return bins;
+}
+
+void FieldStats::reset(const FloatField &field)
+{
+  this->ntiles_i = (field.width + this->tile_size - 1) / this->tile_size;
+  this->ntiles_j = (field.height + this->tile_size - 1) / this->tile_size;
+  this->width = field.width;
+  this->height = field.height;
+
+  size_t ntiles = static_cast<size_t>(this->ntiles_i * this->ntiles_j);
+
+  this->tiles.assign(ntiles, Tile{0.f, 0.f, 0.0});
+  this->tiles_hist.assign(ntiles * static_cast<size_t>(this->nbins), 0);
+  this->hist.assign(static_cast<size_t>(this->nbins), 0);
+  this->sum = 0.0;
+
+  for (int tj = 0; tj < this->ntiles_j; ++tj)
+    for (int ti = 0; ti < this->ntiles_i; ++ti)
+      this->update_tile(field, ti, tj);
+}
+
+void FieldStats::update(const FloatField &field, int x0, int y0, int x1, int y1)
+{
+  if (field.width != this->width || field.height != this->height)
+  {
+    this->reset(field);
+    return;
+  }
+
+  x0 = std::max(x0, 0);
+  y0 = std::max(y0, 0);
+  x1 = std::min(x1, field.width - 1);
+  y1 = std::min(y1, field.height - 1);
+
+  if (x0 > x1 || y0 > y1)
+    return;
+
+  for (int tj = y0 / this->tile_size; tj <= y1 / this->tile_size; ++tj)
+    for (int ti = x0 / this->tile_size; ti <= x1 / this->tile_size; ++ti)
+      this->update_tile(field, ti, tj);
+}
+
+void FieldStats::update_tile(const FloatField &field, int ti, int tj)
+{
+  size_t    tid = static_cast<size_t>(tj * this->ntiles_i + ti);
+  Tile     &tile = this->tiles[tid];
+  uint32_t *tile_hist = &this->tiles_hist[tid * static_cast<size_t>(this->nbins)];
+
+  // remove the previous contribution of the tile from the aggregates
+  this->sum -= tile.sum;
+  for (int k = 0; k < this->nbins; ++k)
+  {
+    this->hist[k] -= tile_hist[k];
+    tile_hist[k] = 0;
+  }
+
+  const int i0 = ti * this->tile_size;
+  const int j0 = tj * this->tile_size;
+  const int i1 = std::min(i0 + this->tile_size, field.width);
+  const int j1 = std::min(j0 + this->tile_size, field.height);
+  const float fbins = SFLOAT(this->nbins);
+
+  tile = Tile{field.at(i0, j0), field.at(i0, j0), 0.0};
+
+  for (int j = j0; j < j1; ++j)
+  {
+    const float *row = &field.data[static_cast<size_t>(j * field.width)];
+    float        row_sum = 0.f;
+
+    for (int i = i0; i < i1; ++i)
+    {
+      float v = row[i];
+      tile.min = std::min(tile.min, v);
+      tile.max = std::max(tile.max, v);
+      row_sum += v;
+
+      int bin = std::clamp(SINT(v * fbins), 0, this->nbins - 1);
+      tile_hist[bin]++;
+    }
+
+    tile.sum += static_cast<double>(row_sum);
+  }
+
+  // add the new contribution
+  this->sum += tile.sum;
+  for (int k = 0; k < this->nbins; ++k)
+    this->hist[k] += tile_hist[k];
+}
+
+} // namespace qsx
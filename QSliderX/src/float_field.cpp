@@ -0,0 +1,386 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "qsx/internal/float_field.hpp"
+#include "qsx/internal/parallel.hpp"
+#include "qsx/internal/utils.hpp"
+
+namespace qsx
+{
+
+// helper, filter kernel and its support radius (in source pixels when
+// upsampling)
+static float filter_support(ResampleFilter filter)
+{
+  switch (filter)
+  {
+  case ResampleFilter::BOX:
+    return 0.5f;
+  case ResampleFilter::BILINEAR:
+    return 1.f;
+  case ResampleFilter::BICUBIC:
+    return 2.f;
+  case ResampleFilter::LANCZOS:
+    return 3.f;
+  default:
+    return 1.f;
+  }
+}
+
+static float filter_kernel(ResampleFilter filter, float x)
+{
+  x = std::abs(x);
+
+  switch (filter)
+  {
+  case ResampleFilter::BOX:
+    return x <= 0.5f ? 1.f : 0.f;
+
+  case ResampleFilter::BILINEAR:
+    return std::max(0.f, 1.f - x);
+
+  case ResampleFilter::BICUBIC:
+  {
+    // Catmull-Rom (Keys a = -0.5)
+    if (x < 1.f)
+      return (1.5f * x - 2.5f) * x * x + 1.f;
+    else if (x < 2.f)
+      return ((-0.5f * x + 2.5f) * x - 4.f) * x + 2.f;
+    return 0.f;
+  }
+
+  case ResampleFilter::LANCZOS:
+  {
+    if (x < 1e-6f)
+      return 1.f;
+    if (x >= 3.f)
+      return 0.f;
+    float px = SFLOAT(M_PI) * x;
+    return 3.f * std::sin(px) * std::sin(px / 3.f) / (px * px);
+  }
+
+  default:
+    return 0.f;
+  }
+}
+
+// source indices and normalized weights contributing to each destination
+// sample along one axis
+struct Contributions
+{
+  std::vector<int>   first; // first source index, per destination sample
+  std::vector<int>   count; // number of taps, per destination sample
+  std::vector<float> weights;
+  int                stride; // max taps
+};
+
+static Contributions compute_contributions(int src_size, int dst_size, ResampleFilter filter)
+{
+  const float scale = SFLOAT(src_size) / SFLOAT(dst_size);
+  const float fscale = std::max(1.f, scale); // widen the kernel when downsampling
+  const float support = filter_support(filter) * fscale;
+
+  Contributions c;
+  c.stride = SINT(std::ceil(2.f * support)) + 2;
+  c.first.resize(dst_size);
+  c.count.resize(dst_size);
+  c.weights.assign(static_cast<size_t>(dst_size * c.stride), 0.f);
+
+  for (int i = 0; i < dst_size; ++i)
+  {
+    float center = (SFLOAT(i) + 0.5f) * scale - 0.5f;
+    int   k0 = SINT(std::ceil(center - support));
+    int   k1 = SINT(std::floor(center + support));
+    k1 = std::min(k1, k0 + c.stride - 1);
+
+    float *w = &c.weights[static_cast<size_t>(i * c.stride)];
+    float  sum = 0.f;
+
+    for (int k = k0; k <= k1; ++k)
+    {
+      w[k - k0] = filter_kernel(filter, (SFLOAT(k) - center) / fscale);
+      sum += w[k - k0];
+    }
+
+    if (sum == 0.f)
+    {
+      // degenerate case, fall back to the nearest sample
+      k0 = SINT(std::round(center));
+      k1 = k0;
+      w[0] = 1.f;
+      sum = 1.f;
+    }
+
+    for (int k = 0; k <= k1 - k0; ++k)
+      w[k] /= sum;
+
+    // fold out-of-range taps onto the edges
+    if (k0 < 0 || k1 >= src_size)
+    {
+      std::vector<float> folded(static_cast<size_t>(c.stride), 0.f);
+      int                kmin = std::clamp(k0, 0, src_size - 1);
+      int                kmax = std::clamp(k1, 0, src_size - 1);
+
+      for (int k = k0; k <= k1; ++k)
+        folded[static_cast<size_t>(std::clamp(k, 0, src_size - 1) - kmin)] += w[k - k0];
+
+      std::copy(folded.begin(), folded.end(), w);
+      k0 = kmin;
+      k1 = kmax;
+    }
+
+    c.first[i] = k0;
+    c.count[i] = k1 - k0 + 1;
+  }
+
+  return c;
+}
+
+QRect fill_polygon(FloatField &field, const std::vector<QPointF> &polygon, float value)
+{
+  const size_t n = polygon.size();
+
+  if (n < 3 || field.width <= 0 || field.height <= 0)
+    return QRect();
+
+  // edge table, edges are bucketed by the first scanline (cell center
+  // row) they cross
+  struct Edge
+  {
+    float ymax;
+    float x;    // intersection with the current scanline
+    float dxdy; // inverse slope
+  };
+
+  std::vector<std::vector<Edge>> edge_table(static_cast<size_t>(field.height));
+
+  for (size_t k = 0; k < n; ++k)
+  {
+    QPointF a = polygon[k];
+    QPointF b = polygon[(k + 1) % n];
+
+    if (a.y() == b.y())
+      continue; // horizontal edges never cross a scanline
+    if (a.y() > b.y())
+      std::swap(a, b);
+
+    float y0 = SFLOAT(a.y());
+    float y1 = SFLOAT(b.y());
+    float dxdy = SFLOAT(b.x() - a.x()) / (y1 - y0);
+    int   js = std::max(0, SINT(std::ceil(y0)));
+
+    if (SFLOAT(js) >= y1 || js >= field.height)
+      continue;
+
+    float x = SFLOAT(a.x()) + (SFLOAT(js) - y0) * dxdy;
+    edge_table[static_cast<size_t>(js)].push_back({y1, x, dxdy});
+  }
+
+  // scan conversion with an active edge table
+  std::vector<Edge> active;
+  int               xmin = field.width;
+  int               xmax = -1;
+  int               ymin = field.height;
+  int               ymax = -1;
+
+  for (int j = 0; j < field.height; ++j)
+  {
+    // drop finished edges, advance the others and add the starting ones
+    std::erase_if(active, [j](const Edge &e) { return SFLOAT(j) >= e.ymax; });
+
+    for (auto &e : active)
+      e.x += e.dxdy;
+
+    for (auto &e : edge_table[static_cast<size_t>(j)])
+      active.push_back(e);
+
+    if (active.empty())
+      continue;
+
+    std::sort(active.begin(),
+              active.end(),
+              [](const Edge &e0, const Edge &e1) { return e0.x < e1.x; });
+
+    // fill the cells with centers in [xa, xb) for each pair of crossings
+    for (size_t k = 0; k + 1 < active.size(); k += 2)
+    {
+      int i0 = std::max(0, SINT(std::ceil(active[k].x)));
+      int i1 = std::min(field.width, SINT(std::ceil(active[k + 1].x)));
+
+      if (i0 >= i1)
+        continue;
+
+      std::fill(field.data.begin() + j * field.width + i0,
+                field.data.begin() + j * field.width + i1,
+                value);
+
+      xmin = std::min(xmin, i0);
+      xmax = std::max(xmax, i1 - 1);
+      ymin = std::min(ymin, j);
+      ymax = std::max(ymax, j);
+    }
+  }
+
+  if (xmin > xmax)
+    return QRect();
+
+  return QRect(QPoint(xmin, ymin), QPoint(xmax, ymax));
+}
+
+QRect flood_fill(FloatField &field,
+                 int         x,
+                 int         y,
+                 float       value,
+                 float       tolerance,
+                 bool        connectivity8)
+{
+  const int w = field.width;
+  const int h = field.height;
+
+  if (x < 0 || y < 0 || x >= w || y >= h)
+    return QRect();
+
+  const float seed_value = field.at(x, y);
+
+  // when the fill value is itself within the tolerance, filled cells need
+  // to be tracked separately
+  const bool           use_mask = std::abs(value - seed_value) <= tolerance;
+  std::vector<uint8_t> filled(use_mask ? field.data.size() : 0, 0);
+
+  auto match = [&](int i, int j)
+  {
+    size_t idx = static_cast<size_t>(j * w + i);
+    return (!use_mask || !filled[idx]) &&
+           std::abs(field.data[idx] - seed_value) <= tolerance;
+  };
+
+  // explicit stack of span seeds
+  std::vector<std::pair<int, int>> stack;
+  stack.reserve(static_cast<size_t>(2 * (w + h)));
+  stack.push_back({x, y});
+
+  int xmin = x;
+  int xmax = x;
+  int ymin = y;
+  int ymax = y;
+
+  while (!stack.empty())
+  {
+    auto [sx, sy] = stack.back();
+    stack.pop_back();
+
+    if (!match(sx, sy))
+      continue;
+
+    // extend the span to the left and to the right
+    int xl = sx;
+    int xr = sx;
+
+    while (xl > 0 && match(xl - 1, sy))
+      xl--;
+    while (xr < w - 1 && match(xr + 1, sy))
+      xr++;
+
+    std::fill(field.data.begin() + sy * w + xl, field.data.begin() + sy * w + xr + 1, value);
+
+    if (use_mask)
+      std::fill(filled.begin() + sy * w + xl, filled.begin() + sy * w + xr + 1, 1);
+
+    xmin = std::min(xmin, xl);
+    xmax = std::max(xmax, xr);
+    ymin = std::min(ymin, sy);
+    ymax = std::max(ymax, sy);
+
+    // push one seed per matching run in the rows above and below
+    int i0 = connectivity8 ? std::max(xl - 1, 0) : xl;
+    int i1 = connectivity8 ? std::min(xr + 1, w - 1) : xr;
+
+    for (int ny : {sy - 1, sy + 1})
+    {
+      if (ny < 0 || ny >= h)
+        continue;
+
+      bool in_run = false;
+
+      for (int i = i0; i <= i1; ++i)
+      {
+        bool m = match(i, ny);
+        if (m && !in_run)
+          stack.push_back({i, ny});
+        in_run = m;
+      }
+    }
+  }
+
+  return QRect(QPoint(xmin, ymin), QPoint(xmax, ymax));
+}
+
+FloatField resample(const FloatField &src,
+                    int               new_width,
+                    int               new_height,
+                    ResampleFilter    filter)
+{
+  FloatField out(new_width, new_height);
+
+  if (new_width <= 0 || new_height <= 0 || src.width <= 0 || src.height <= 0)
+    return out;
+
+  const Contributions cx = compute_contributions(src.width, new_width, filter);
+  const Contributions cy = compute_contributions(src.height, new_height, filter);
+
+  // horizontal pass: src.height rows of new_width samples
+  FloatField tmp(new_width, src.height);
+
+  parallel_for(0,
+               src.height,
+               [&](int j0, int j1)
+               {
+                 for (int j = j0; j < j1; ++j)
+                 {
+                   const float *src_row = &src.data[static_cast<size_t>(j * src.width)];
+                   float       *tmp_row = &tmp.data[static_cast<size_t>(j * new_width)];
+
+                   for (int i = 0; i < new_width; ++i)
+                   {
+                     const float *w = &cx.weights[static_cast<size_t>(i * cx.stride)];
+                     const float *s = src_row + cx.first[i];
+                     float        sum = 0.f;
+
+                     for (int k = 0; k < cx.count[i]; ++k)
+                       sum += w[k] * s[k];
+
+                     tmp_row[i] = sum;
+                   }
+                 }
+               });
+
+  // vertical pass, accumulates whole rows to stay cache friendly
+  parallel_for(0,
+               new_height,
+               [&](int j0, int j1)
+               {
+                 for (int j = j0; j < j1; ++j)
+                 {
+                   const float *w = &cy.weights[static_cast<size_t>(j * cy.stride)];
+                   float       *out_row = &out.data[static_cast<size_t>(j * new_width)];
+
+                   for (int k = 0; k < cy.count[j]; ++k)
+                   {
+                     const float *tmp_row = &tmp.data[static_cast<size_t>(
+                         (cy.first[j] + k) * new_width)];
+                     const float wk = w[k];
+
+                     for (int i = 0; i < new_width; ++i)
+                       out_row[i] += wk * tmp_row[i];
+                   }
+                 }
+               });
+
+  return out;
+}
+
+} // namespace qsx
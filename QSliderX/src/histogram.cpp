@@ -0,0 +1,55 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <mutex>
+
+#include "qsx/internal/histogram.hpp"
+#include "qsx/internal/parallel.hpp"
+#include "qsx/internal/utils.hpp"
+
+namespace qsx
+{
+
+// Counts the values of 'data' in [0, 1] in 'nbins' bins, by blocks of values
+// split across threads, each thread filling its own partial histogram merged
+// at the end. Returns an empty histogram when canceled.
+std::vector<uint64_t> compute_histogram(std::span<const float>   data,
+                                        int                      nbins,
+                                        const std::atomic<bool> &cancel)
+{
+  constexpr size_t block = 1 << 16;
+  const int        nblocks = SINT((data.size() + block - 1) / block);
+  const float      scale = SFLOAT(nbins);
+
+  std::vector<uint64_t> bins(nbins, 0);
+  std::mutex            mutex;
+
+  auto fct = [&](int b0, int b1)
+  {
+    std::vector<uint64_t> partial(nbins, 0);
+
+    for (int b = b0; b < b1 && !cancel; ++b)
+    {
+      const size_t i1 = std::min(data.size(), static_cast<size_t>(b + 1) * block);
+
+      // NaN fails the range test
+      for (size_t i = static_cast<size_t>(b) * block; i < i1; ++i)
+        if (data[i] >= 0.f && data[i] <= 1.f)
+          ++partial[std::min(SINT(data[i] * scale), nbins - 1)];
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int k = 0; k < nbins; ++k)
+      bins[k] += partial[k];
+  };
+
+  parallel_for(0, nblocks, fct);
+
+  if (cancel)
+    return {};
+
+  return bins;
+}
+
+} // namespace qsx
@@ -24,7 +24,8 @@ bool is_monotonic(const std::vector<float> &data)
 
 Interpolator1D::Interpolator1D(const std::vector<float> &x,
                                const std::vector<float> &y,
-                               InterpolationMethod1D     method)
+                               InterpolationMethod1D     method,
+                               InterpolationEngine1D     engine_)
 {
   if (x.size() != y.size() || x.size() < 2)
   {
@@ -37,71 +38,150 @@ Interpolator1D::Interpolator1D(const std::vector<float> &x,
     throw std::invalid_argument("Steffen interpolation requires monotonic y data.");
   }
 
-  this->x_data = std::vector<double>(x.begin(), x.end());
-  this->y_data = std::vector<double>(y.begin(), y.end());
+  // converted to double for GSL, copied by gsl_spline_init
+  const std::vector<double> x_data(x.begin(), x.end());
+  const std::vector<double> y_data(y.begin(), y.end());
 
-  const size_t size = this->x_data.size();
+  const size_t size = x_data.size();
 
   // store min and max values after double conversion to clamp input
   // interpolation values and avoid rounding issues
-  this->xmin = *std::min_element(this->x_data.begin(), this->x_data.end());
-  this->xmax = *std::max_element(this->x_data.begin(), this->x_data.end());
-
-  // initialize the GSL interpolation accelerator
-  this->accel_ = gsl_interp_accel_alloc();
+  this->xmin = *std::min_element(x_data.begin(), x_data.end());
+  this->xmax = *std::max_element(x_data.begin(), x_data.end());
 
   // select the appropriate interpolation method
+  const gsl_interp_type *type = nullptr;
+
   switch (method)
   {
 
   case InterpolationMethod1D::AKIMA:
-    this->interp = gsl_spline_alloc(gsl_interp_akima, size);
+    type = gsl_interp_akima;
     break;
 
   case InterpolationMethod1D::AKIMA_PERIODIC:
-    this->interp = gsl_spline_alloc(gsl_interp_akima_periodic, size);
+    type = gsl_interp_akima_periodic;
     break;
 
   case InterpolationMethod1D::CUBIC:
-    this->interp = gsl_spline_alloc(gsl_interp_cspline, size);
+    type = gsl_interp_cspline;
     break;
 
   case InterpolationMethod1D::CUBIC_PERIODIC:
-    this->interp = gsl_spline_alloc(gsl_interp_cspline_periodic, size);
+    type = gsl_interp_cspline_periodic;
     break;
 
   case InterpolationMethod1D::LINEAR:
-    this->interp = gsl_spline_alloc(gsl_interp_linear, size);
+    type = gsl_interp_linear;
     break;
 
   case InterpolationMethod1D::POLYNOMIAL:
-    this->interp = gsl_spline_alloc(gsl_interp_polynomial, size);
+    type = gsl_interp_polynomial;
     break;
 
   case InterpolationMethod1D::STEFFEN:
-    this->interp = gsl_spline_alloc(gsl_interp_steffen, size);
+    type = gsl_interp_steffen;
     break;
 
   default:
     throw std::invalid_argument("Unsupported interpolation method.");
   }
 
-  gsl_spline_init(this->interp, this->x_data.data(), this->y_data.data(), size);
+  // checked here, GSL would call its (aborting) error handler
+  if (size < gsl_interp_type_min_size(type))
+  {
+    throw std::invalid_argument("Interpolation method requires at least " +
+                                std::to_string(gsl_interp_type_min_size(type)) +
+                                " points.");
+  }
+
+  for (size_t k = 1; k < size; ++k)
+    if (!(x_data[k] > x_data[k - 1]))
+      throw std::invalid_argument("x values must be strictly increasing.");
+
+  // same minimum sizes and segments as GSL, evaluated in single precision
+  this->engine = engine_;
+
+  if (engine_ == ENGINE_NATIVE)
+  {
+    switch (method)
+    {
+    case InterpolationMethod1D::AKIMA:
+      this->native.set_akima(x, y);
+      return;
+
+    case InterpolationMethod1D::CUBIC:
+      this->native.set_natural_cubic(x, y);
+      return;
+
+    case InterpolationMethod1D::LINEAR:
+      this->native.set_linear(x, y);
+      return;
+
+    case InterpolationMethod1D::STEFFEN:
+      this->native.set_steffen(x, y);
+      return;
+
+    default:
+      this->engine = ENGINE_GSL;
+    }
+  }
+
+  gsl_spline *spline = gsl_spline_alloc(type, size);
+  gsl_spline_init(spline, x_data.data(), y_data.data(), size);
+
+  // released with the last copy
+  this->interp = std::shared_ptr<const gsl_spline>(spline, gsl_spline_free);
 }
 
-Interpolator1D::~Interpolator1D()
+void Interpolator1D::evaluate(std::span<const float> x, std::span<float> y) const
 {
-  gsl_spline_free(this->interp);
-  gsl_interp_accel_free(this->accel_);
+  // any order, the constant extrapolation matches the clamping
+  if (this->engine == ENGINE_NATIVE)
+  {
+    this->native.evaluate(x, y);
+    return;
+  }
+
+  const size_t  n = std::min(x.size(), y.size());
+  const double *xa = this->interp->x;
+  const size_t  size = this->interp->size;
+
+  // own accelerator, its cache is set to the segment found by the sweep so
+  // that GSL does not search again
+  gsl_interp_accel accel;
+  gsl_interp_accel_reset(&accel);
+
+  size_t k = 0;
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    const double xd = std::clamp(static_cast<double>(x[i]), this->xmin, this->xmax);
+
+    if (xd < xa[k])
+      k = static_cast<size_t>(std::upper_bound(xa, xa + k, xd) - xa) - 1;
+    else
+      while (k + 2 < size && xd >= xa[k + 1])
+        ++k;
+
+    accel.cache = k;
+    y[i] = SFLOAT(gsl_spline_eval(this->interp.get(), xd, &accel));
+  }
 }
 
+InterpolationEngine1D Interpolator1D::get_engine() const { return this->engine; }
+
 float Interpolator1D::operator()(float x) const { return this->interpolate(x); }
 
 float Interpolator1D::interpolate(float x) const
 {
+  if (this->engine == ENGINE_NATIVE)
+    return this->native.evaluate(x);
+
   double xd = static_cast<double>(x);
   xd = std::clamp(xd, this->xmin, this->xmax);
-  double result = gsl_spline_eval(this->interp, xd, accel_);
+  // no accelerator, nothing to reuse for a single point
+  double result = gsl_spline_eval(this->interp.get(), xd, nullptr);
   return SFLOAT(result);
 }
 
@@ -0,0 +1,53 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "qsx/internal/parallel.hpp"
+
+namespace qsx
+{
+
+void parallel_for(int                                 begin,
+                  int                                 end,
+                  const std::function<void(int, int)> &fct,
+                  int                                 grain)
+{
+  const int count = end - begin;
+  if (count <= 0)
+    return;
+
+  int nthreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  nthreads = std::clamp(count / std::max(1, grain), 1, nthreads);
+
+  if (nthreads == 1)
+  {
+    fct(begin, end);
+    return;
+  }
+
+  const int chunk = (count + nthreads - 1) / nthreads;
+
+  std::vector<std::thread> workers;
+  workers.reserve(static_cast<size_t>(nthreads - 1));
+
+  // last chunk is processed by the calling thread
+  for (int k = 0; k < nthreads - 1; ++k)
+  {
+    int i0 = begin + k * chunk;
+    int i1 = std::min(end, i0 + chunk);
+    if (i0 < i1)
+      workers.emplace_back(fct, i0, i1);
+  }
+
+  int i0 = begin + (nthreads - 1) * chunk;
+  if (i0 < end)
+    fct(i0, end);
+
+  for (auto &t : workers)
+    t.join();
+}
+
+} // namespace qsx
@@ -0,0 +1,420 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <cmath>
+
+#include "qsx/internal/piecewise_cubic.hpp"
+#include "qsx/internal/utils.hpp"
+
+namespace qsx
+{
+
+// Akima tangents from the slopes extended by two values at each end (as GSL
+// does), the segments with locally collinear points are kept linear.
+void PiecewiseCubic::build_akima()
+{
+  const int n = SINT(this->knots.size());
+  const float *x = this->knots.data();
+  const float *y = this->knot_values.data();
+
+  // slopes m[i] stored at m[i + 2], i in [-2, n]
+  std::vector<double> m(static_cast<size_t>(n + 3));
+
+  for (int i = 0; i < n - 1; ++i)
+    m[i + 2] = (double(y[i + 1]) - double(y[i])) / (double(x[i + 1]) - double(x[i]));
+
+  m[0] = 3.0 * m[2] - 2.0 * m[3];
+  m[1] = 2.0 * m[2] - m[3];
+  m[n + 1] = 2.0 * m[n] - m[n - 1];
+  m[n + 2] = 3.0 * m[n] - 2.0 * m[n - 1];
+
+  // tangent at the knot i, 'fallback' when the weights vanish
+  auto tangent = [&m](int i, double fallback)
+  {
+    const double w0 = std::abs(m[i + 3] - m[i + 2]);
+    const double w1 = std::abs(m[i + 1] - m[i]);
+    return w0 + w1 == 0.0 ? fallback : (w0 * m[i + 1] + w1 * m[i + 2]) / (w0 + w1);
+  };
+
+  for (int k = 0; k < n - 1; ++k)
+  {
+    const double mk = m[k + 2];
+
+    if (std::abs(m[k + 3] - mk) + std::abs(m[k + 1] - m[k]) == 0.0)
+      this->set_hermite_segment(k, mk, mk);
+    else
+      this->set_hermite_segment(k, tangent(k, mk), tangent(k + 1, mk));
+  }
+}
+
+// Second derivatives with zero end values, tridiagonal system solved by the
+// Thomas algorithm, then the tangents at the segment end points.
+void PiecewiseCubic::build_natural_cubic()
+{
+  const int n = SINT(this->knots.size());
+  const float *x = this->knots.data();
+  const float *y = this->knot_values.data();
+
+  std::vector<double> h(n - 1), s(n - 1);
+
+  for (int i = 0; i < n - 1; ++i)
+  {
+    h[i] = double(x[i + 1]) - double(x[i]);
+    s[i] = (double(y[i + 1]) - double(y[i])) / h[i];
+  }
+
+  // c = half the second derivatives, unknowns c[1] .. c[n - 2]
+  std::vector<double> c(n, 0.0), diag(n, 0.0), rhs(n, 0.0);
+
+  for (int i = 1; i < n - 1; ++i)
+  {
+    diag[i] = 2.0 * (h[i - 1] + h[i]);
+    rhs[i] = 3.0 * (s[i] - s[i - 1]);
+
+    if (i > 1)
+    {
+      const double w = h[i - 1] / diag[i - 1];
+      diag[i] -= w * h[i - 1];
+      rhs[i] -= w * rhs[i - 1];
+    }
+  }
+
+  for (int i = n - 2; i >= 1; --i)
+    c[i] = (rhs[i] - h[i] * c[i + 1]) / diag[i];
+
+  for (int k = 0; k < n - 1; ++k)
+  {
+    const double t0 = s[k] - h[k] * (2.0 * c[k] + c[k + 1]) / 3.0;
+    const double t1 = s[k] + h[k] * (c[k] + 2.0 * c[k + 1]) / 3.0;
+    this->set_hermite_segment(k, t0, t1);
+  }
+}
+
+void PiecewiseCubic::build_segments()
+{
+  const int n = SINT(this->knots.size());
+
+  if (n < 3 && this->kind != Kind::CATMULL_ROM)
+    this->kind = Kind::LINEAR;
+
+  switch (this->kind)
+  {
+  case Kind::AKIMA:
+    this->build_akima();
+    break;
+
+  case Kind::NATURAL_CUBIC:
+    this->build_natural_cubic();
+    break;
+
+  case Kind::STEFFEN:
+    this->build_steffen();
+    break;
+
+  default:
+    for (int k = 0; k < SINT(this->coeffs.size()); ++k)
+      this->set_segment(k);
+  }
+
+  this->update_grid();
+}
+
+// Steffen tangents (monotonic between the knots), the end tangents are the
+// end slopes as in GSL.
+void PiecewiseCubic::build_steffen()
+{
+  const int n = SINT(this->knots.size());
+  const float *x = this->knots.data();
+  const float *y = this->knot_values.data();
+
+  std::vector<double> h(n - 1), s(n - 1), t(n);
+
+  for (int i = 0; i < n - 1; ++i)
+  {
+    h[i] = double(x[i + 1]) - double(x[i]);
+    s[i] = (double(y[i + 1]) - double(y[i])) / h[i];
+  }
+
+  t.front() = s.front();
+  t.back() = s.back();
+
+  for (int i = 1; i < n - 1; ++i)
+  {
+    const double p = (s[i - 1] * h[i] + s[i] * h[i - 1]) / (h[i - 1] + h[i]);
+    t[i] = (std::copysign(1.0, s[i - 1]) + std::copysign(1.0, s[i])) *
+           std::min({std::abs(s[i - 1]), std::abs(s[i]), 0.5 * std::abs(p)});
+  }
+
+  for (int k = 0; k < n - 1; ++k)
+    this->set_hermite_segment(k, t[k], t[k + 1]);
+}
+
+float PiecewiseCubic::evaluate(float x) const
+{
+  if (this->knots.empty())
+    return 0.f;
+  if (x <= this->knots.front())
+    return this->knot_values.front();
+  if (x >= this->knots.back())
+    return this->knot_values.back();
+
+  return this->evaluate_segment(this->find_segment(x), x);
+}
+
+void PiecewiseCubic::evaluate(std::span<const float> x, std::span<float> y) const
+{
+  const size_t n = std::min(x.size(), y.size());
+
+  if (this->coeffs.empty())
+  {
+    std::fill_n(y.begin(), n, this->knots.empty() ? 0.f : this->knot_values.front());
+    return;
+  }
+
+  const float x_front = this->knots.front();
+  const float x_back = this->knots.back();
+
+  constexpr size_t         block = 256;
+  std::array<int, block>   seg;
+  std::array<float, block> dx;
+
+  for (size_t i0 = 0; i0 < n; i0 += block)
+  {
+    const size_t m = std::min(block, n - i0);
+
+    // clamped to the knots range, NaN propagated (first segment, NaN dx)
+    for (size_t i = 0; i < m; ++i)
+    {
+      const float xi = std::clamp(x[i0 + i], x_front, x_back);
+      seg[i] = this->find_segment(xi);
+      dx[i] = xi - this->knots[seg[i]];
+    }
+
+    for (size_t i = 0; i < m; ++i)
+    {
+      const auto &[a, b, c, d] = this->coeffs[seg[i]];
+      y[i0 + i] = a + dx[i] * (b + dx[i] * (c + dx[i] * d));
+    }
+  }
+}
+
+float PiecewiseCubic::evaluate_segment(int k, float x) const
+{
+  const auto &[a, b, c, d] = this->coeffs[k];
+  const float dx = x - this->knots[k];
+  return a + dx * (b + dx * (c + dx * d));
+}
+
+void PiecewiseCubic::evaluate_sorted(std::span<const float> x, std::span<float> y) const
+{
+  const size_t n = std::min(x.size(), y.size());
+
+  if (this->knots.empty())
+  {
+    std::fill_n(y.begin(), n, 0.f);
+    return;
+  }
+
+  const float x_front = this->knots.front();
+  const float x_back = this->knots.back();
+  int         k = 0;
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    const float xi = x[i];
+
+    if (xi <= x_front)
+      y[i] = this->knot_values.front();
+    else if (xi >= x_back)
+      y[i] = this->knot_values.back();
+    else
+    {
+      if (xi < this->knots[k])
+        k = this->find_segment(xi);
+      else
+        while (xi >= this->knots[k + 1])
+          ++k;
+
+      y[i] = this->evaluate_segment(k, xi);
+    }
+  }
+}
+
+int PiecewiseCubic::find_segment(float x) const
+{
+  const int nseg = SINT(this->coeffs.size());
+
+  if (nseg < 2)
+    return 0;
+
+  // cell of the grid, then the few segments it overlaps (rounding may also
+  // put 'x' just before the segment of the cell)
+  const float t = std::min((x - this->grid_x0) * this->grid_scale,
+                           SFLOAT(this->grid.size() - 1));
+  int         k = this->grid[t > 0.f ? SINT(t) : 0];
+
+  while (k > 0 && x < this->knots[k])
+    --k;
+  while (k < nseg - 1 && x >= this->knots[k + 1])
+    ++k;
+
+  return k;
+}
+
+void PiecewiseCubic::move_knots(int                    first,
+                                std::span<const float> x,
+                                std::span<const float> y)
+{
+  const int n = SINT(this->knots.size());
+  const int count = SINT(std::min(x.size(), y.size()));
+
+  if (first < 0 || first + count > n)
+    return;
+
+  std::copy_n(x.begin(), count, this->knots.begin() + first);
+  std::copy_n(y.begin(), count, this->knot_values.begin() + first);
+
+  if (this->kind != Kind::LINEAR && this->kind != Kind::CATMULL_ROM)
+  {
+    this->build_segments();
+    return;
+  }
+
+  // segments using the moved knots, the Catmull-Rom tangents reach the
+  // neighbors of the segment end points
+  const int reach = this->kind == Kind::CATMULL_ROM ? 1 : 0;
+  const int k0 = std::max(first - 1 - reach, 0);
+  const int k1 = std::min(first + count - 1 + reach, n - 2);
+
+  for (int k = k0; k <= k1; ++k)
+    this->set_segment(k);
+
+  this->update_grid();
+}
+
+void PiecewiseCubic::reset_knots(std::span<const float> x, std::span<const float> y)
+{
+  const size_t n = std::min(x.size(), y.size());
+
+  this->knots.assign(x.begin(), x.begin() + n);
+  this->knot_values.assign(y.begin(), y.begin() + n);
+  this->coeffs.resize(n > 0 ? n - 1 : 0);
+}
+
+void PiecewiseCubic::set_akima(std::span<const float> x, std::span<const float> y)
+{
+  this->kind = Kind::AKIMA;
+  this->reset_knots(x, y);
+  this->build_segments();
+}
+
+void PiecewiseCubic::set_catmull_rom(std::span<const float> x, std::span<const float> y)
+{
+  this->kind = Kind::CATMULL_ROM;
+  this->reset_knots(x, y);
+  this->build_segments();
+}
+
+void PiecewiseCubic::set_hermite_segment(int k, double t0, double t1)
+{
+  const double y0 = this->knot_values[k];
+  const double h = double(this->knots[k + 1]) - double(this->knots[k]);
+
+  if (h <= 0.0)
+  {
+    this->coeffs[k] = {SFLOAT(y0), 0.f, 0.f, 0.f};
+    return;
+  }
+
+  const double s = (double(this->knot_values[k + 1]) - y0) / h;
+  const double c = (3.0 * s - 2.0 * t0 - t1) / h;
+  const double d = (t0 + t1 - 2.0 * s) / (h * h);
+
+  this->coeffs[k] = {SFLOAT(y0), SFLOAT(t0), SFLOAT(c), SFLOAT(d)};
+}
+
+void PiecewiseCubic::set_linear(std::span<const float> x, std::span<const float> y)
+{
+  this->kind = Kind::LINEAR;
+  this->reset_knots(x, y);
+  this->build_segments();
+}
+
+void PiecewiseCubic::set_natural_cubic(std::span<const float> x, std::span<const float> y)
+{
+  this->kind = Kind::NATURAL_CUBIC;
+  this->reset_knots(x, y);
+  this->build_segments();
+}
+
+void PiecewiseCubic::set_segment(int k)
+{
+  const int    n = SINT(this->knots.size());
+  const float *y = this->knot_values.data();
+  const float  h = this->knots[k + 1] - this->knots[k];
+
+  if (h <= 0.f)
+  {
+    this->coeffs[k] = {y[k], 0.f, 0.f, 0.f};
+    return;
+  }
+
+  if (this->kind == Kind::LINEAR)
+  {
+    this->coeffs[k] = {y[k], (y[k + 1] - y[k]) / h, 0.f, 0.f};
+    return;
+  }
+
+  const float y0 = y[std::max(k - 1, 0)];
+  const float y1 = y[k];
+  const float y2 = y[k + 1];
+  const float y3 = y[std::min(k + 2, n - 1)];
+
+  // polynomial in u = dx / h, then rescaled to dx
+  const float b = 0.5f * (y2 - y0);
+  const float c = 0.5f * (2.f * y0 - 5.f * y1 + 4.f * y2 - y3);
+  const float d = 0.5f * (-y0 + 3.f * y1 - 3.f * y2 + y3);
+
+  this->coeffs[k] = {y1, b / h, c / (h * h), d / (h * h * h)};
+}
+
+void PiecewiseCubic::set_steffen(std::span<const float> x, std::span<const float> y)
+{
+  this->kind = Kind::STEFFEN;
+  this->reset_knots(x, y);
+  this->build_segments();
+}
+
+// Two cells per segment, a lookup only walks over a couple of segments for
+// evenly spread knots.
+void PiecewiseCubic::update_grid()
+{
+  const int nseg = SINT(this->coeffs.size());
+
+  this->grid.clear();
+
+  if (nseg < 2)
+    return;
+
+  const int   ncells = 2 * nseg;
+  const float range = this->knots.back() - this->knots.front();
+
+  this->grid_x0 = this->knots.front();
+  this->grid_scale = range > 0.f ? SFLOAT(ncells) / range : 0.f;
+  this->grid.resize(ncells);
+
+  int k = 0;
+
+  for (int j = 0; j < ncells; ++j)
+  {
+    const float xj = this->grid_x0 + range * SFLOAT(j) / SFLOAT(ncells);
+
+    while (k < nseg - 1 && xj >= this->knots[k + 1])
+      ++k;
+
+    this->grid[j] = k;
+  }
+}
+
+} // namespace qsx
@@ -0,0 +1,361 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#include "qsx/internal/logger.hpp"
+#include "qsx/internal/point_cloud_io.hpp"
+
+namespace qsx
+{
+
+static constexpr char     BINARY_MAGIC[4] = {'Q', 'S', 'X', 'P'};
+static constexpr uint32_t BINARY_VERSION = 1;
+static constexpr size_t   BINARY_HEADER_SIZE = 16;
+static constexpr size_t   CHUNK_SIZE = 1 << 20; // bytes
+
+// --- helpers
+
+static uint32_t byteswap32(uint32_t v)
+{
+  return (v >> 24) | ((v >> 8) & 0xFF00u) | ((v << 8) & 0xFF0000u) | (v << 24);
+}
+
+static void to_little_endian(float *data, size_t n)
+{
+  if constexpr (std::endian::native == std::endian::big)
+    for (size_t k = 0; k < n; ++k)
+      data[k] = std::bit_cast<float>(byteswap32(std::bit_cast<uint32_t>(data[k])));
+}
+
+static uint64_t decode_le(const unsigned char *bytes, int nbytes)
+{
+  uint64_t v = 0;
+  for (int k = nbytes - 1; k >= 0; --k)
+    v = (v << 8) | bytes[k];
+  return v;
+}
+
+static void encode_le(uint64_t v, unsigned char *bytes, int nbytes)
+{
+  for (int k = 0; k < nbytes; ++k)
+  {
+    bytes[k] = static_cast<unsigned char>(v & 0xFF);
+    v >>= 8;
+  }
+}
+
+static bool is_separator(char c)
+{
+  return c == ',' || c == ';' || c == ' ' || c == '\t' || c == '\r';
+}
+
+// parse up to three numbers from the line [first, last), returns the number
+// of values read (stops at the first token that is not a number)
+static int parse_csv_line(const char *first, const char *last, float values[3])
+{
+  int count = 0;
+
+  while (count < 3)
+  {
+    while (first < last && is_separator(*first))
+      ++first;
+
+    if (first == last)
+      break;
+
+    // from_chars does not accept a leading '+'
+    if (*first == '+')
+      ++first;
+
+    auto [ptr, ec] = std::from_chars(first, last, values[count]);
+    if (ec != std::errc() || (ptr < last && !is_separator(*ptr)))
+      break;
+
+    first = ptr;
+    ++count;
+  }
+
+  return count;
+}
+
+// --- CSV
+
+bool read_points_csv(const std::string  &fname,
+                     std::vector<float> &x,
+                     std::vector<float> &y,
+                     std::vector<float> &z,
+                     int                 decimation)
+{
+  std::ifstream f(fname, std::ios::binary);
+
+  if (!f)
+  {
+    Logger::log()->error("read_points_csv: could not open file {}", fname);
+    return false;
+  }
+
+  decimation = std::max(decimation, 1);
+
+  x.clear();
+  y.clear();
+  z.clear();
+
+  // chunked reading, the incomplete last line of a chunk is moved to the
+  // beginning of the buffer before reading the next chunk
+  std::vector<char> buffer(CHUNK_SIZE);
+  size_t            pending = 0;
+  size_t            line_count = 0;
+  bool              eof = false;
+
+  while (!eof)
+  {
+    f.read(buffer.data() + pending,
+           static_cast<std::streamsize>(buffer.size() - pending));
+    size_t nread = static_cast<size_t>(f.gcount());
+    eof = nread == 0 || !f;
+
+    const char *first = buffer.data();
+    const char *end = buffer.data() + pending + nread;
+
+    while (true)
+    {
+      const char *nl = static_cast<const char *>(std::memchr(first, '\n', end - first));
+      if (!nl)
+      {
+        // flush the last line at the end of the file
+        if (!eof)
+          break;
+        nl = end;
+      }
+
+      float values[3] = {0.f, 0.f, 1.f};
+
+      if (parse_csv_line(first, nl, values) >= 2)
+      {
+        if (line_count % decimation == 0)
+        {
+          x.push_back(values[0]);
+          y.push_back(values[1]);
+          z.push_back(values[2]);
+        }
+        ++line_count;
+      }
+
+      if (nl == end)
+        break;
+      first = nl + 1;
+    }
+
+    pending = static_cast<size_t>(end - first);
+
+    // line longer than the buffer
+    if (!eof && pending == buffer.size())
+    {
+      Logger::log()->error("read_points_csv: line too long in file {}", fname);
+      return false;
+    }
+
+    std::memmove(buffer.data(), first, pending);
+  }
+
+  return true;
+}
+
+bool write_points_csv(const std::string     &fname,
+                      std::span<const float> x,
+                      std::span<const float> y,
+                      std::span<const float> z)
+{
+  std::ofstream f(fname, std::ios::binary);
+
+  if (!f)
+  {
+    Logger::log()->error("write_points_csv: could not open file {}", fname);
+    return false;
+  }
+
+  const size_t n = std::min({x.size(), y.size(), z.size()});
+
+  // values are formatted in a chunk buffer, written when nearly full
+  std::string buffer = "x,y,z\n";
+  char        str[64];
+
+  buffer.reserve(CHUNK_SIZE);
+
+  for (size_t k = 0; k < n; ++k)
+  {
+    for (float v : {x[k], y[k], z[k]})
+    {
+      auto [ptr, ec] = std::to_chars(str, str + sizeof(str), v);
+      buffer.append(str, ptr);
+      buffer.push_back(',');
+    }
+    buffer.back() = '\n';
+
+    if (buffer.size() > CHUNK_SIZE - 256)
+    {
+      f.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      buffer.clear();
+    }
+  }
+
+  f.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+  if (!f)
+  {
+    Logger::log()->error("write_points_csv: could not write file {}", fname);
+    return false;
+  }
+
+  return true;
+}
+
+// --- binary
+
+bool read_points_binary(const std::string  &fname,
+                        std::vector<float> &x,
+                        std::vector<float> &y,
+                        std::vector<float> &z,
+                        int                 decimation)
+{
+  std::ifstream f(fname, std::ios::binary | std::ios::ate);
+
+  if (!f)
+  {
+    Logger::log()->error("read_points_binary: could not open file {}", fname);
+    return false;
+  }
+
+  const size_t file_size = static_cast<size_t>(f.tellg());
+  f.seekg(0);
+
+  unsigned char header[BINARY_HEADER_SIZE] = {};
+  f.read(reinterpret_cast<char *>(header), BINARY_HEADER_SIZE);
+
+  if (!f || std::memcmp(header, BINARY_MAGIC, 4) != 0)
+  {
+    Logger::log()->error("read_points_binary: not a point cloud file {}", fname);
+    return false;
+  }
+
+  const uint32_t version = static_cast<uint32_t>(decode_le(header + 4, 4));
+  const uint64_t count = decode_le(header + 8, 8);
+
+  if (version != BINARY_VERSION)
+  {
+    Logger::log()->error("read_points_binary: unsupported version {} in file {}",
+                         version,
+                         fname);
+    return false;
+  }
+
+  if (file_size < BINARY_HEADER_SIZE || (file_size - BINARY_HEADER_SIZE) / 12 < count)
+  {
+    Logger::log()->error("read_points_binary: truncated file {}", fname);
+    return false;
+  }
+
+  const size_t n = static_cast<size_t>(count);
+  const size_t step = static_cast<size_t>(std::max(decimation, 1));
+
+  // each array is read straight into its destination, or in chunks when
+  // decimating
+  for (std::vector<float> *array : {&x, &y, &z})
+  {
+    if (step == 1)
+    {
+      array->resize(n);
+      f.read(reinterpret_cast<char *>(array->data()),
+             static_cast<std::streamsize>(n * sizeof(float)));
+      to_little_endian(array->data(), n);
+    }
+    else
+    {
+      std::vector<float> chunk(CHUNK_SIZE / sizeof(float));
+
+      array->clear();
+      array->reserve((n + step - 1) / step);
+
+      for (size_t k0 = 0; k0 < n; k0 += chunk.size())
+      {
+        size_t m = std::min(chunk.size(), n - k0);
+        f.read(reinterpret_cast<char *>(chunk.data()),
+               static_cast<std::streamsize>(m * sizeof(float)));
+        to_little_endian(chunk.data(), m);
+
+        // first kept index in this chunk
+        for (size_t k = (step - k0 % step) % step; k < m; k += step)
+          array->push_back(chunk[k]);
+      }
+    }
+
+    if (!f)
+    {
+      Logger::log()->error("read_points_binary: could not read file {}", fname);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool write_points_binary(const std::string     &fname,
+                         std::span<const float> x,
+                         std::span<const float> y,
+                         std::span<const float> z)
+{
+  std::ofstream f(fname, std::ios::binary);
+
+  if (!f)
+  {
+    Logger::log()->error("write_points_binary: could not open file {}", fname);
+    return false;
+  }
+
+  const size_t n = std::min({x.size(), y.size(), z.size()});
+
+  unsigned char header[BINARY_HEADER_SIZE] = {};
+  std::memcpy(header, BINARY_MAGIC, 4);
+  encode_le(BINARY_VERSION, header + 4, 4);
+  encode_le(n, header + 8, 8);
+
+  f.write(reinterpret_cast<const char *>(header), BINARY_HEADER_SIZE);
+
+  for (std::span<const float> array : {x, y, z})
+  {
+    if constexpr (std::endian::native == std::endian::little)
+    {
+      f.write(reinterpret_cast<const char *>(array.data()),
+              static_cast<std::streamsize>(n * sizeof(float)));
+    }
+    else
+    {
+      std::vector<float> chunk(CHUNK_SIZE / sizeof(float));
+
+      for (size_t k0 = 0; k0 < n; k0 += chunk.size())
+      {
+        size_t m = std::min(chunk.size(), n - k0);
+        std::copy_n(array.begin() + k0, m, chunk.begin());
+        to_little_endian(chunk.data(), m);
+        f.write(reinterpret_cast<const char *>(chunk.data()),
+                static_cast<std::streamsize>(m * sizeof(float)));
+      }
+    }
+  }
+
+  if (!f)
+  {
+    Logger::log()->error("write_points_binary: could not write file {}", fname);
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace qsx
@@ -0,0 +1,352 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <cmath>
+
+#include "qsx/internal/logger.hpp"
+#include "qsx/internal/parallel.hpp"
+#include "qsx/internal/points_rasterizer.hpp"
+#include "qsx/internal/utils.hpp"
+
+namespace qsx
+{
+
+// dense solve above this count would be too slow for interactive use
+static constexpr int TPS_MAX_POINTS = 512;
+
+// thin-plate radial basis function, r^2 log(r) written with r^2
+static double tps_kernel(double r2) { return r2 > 0.0 ? 0.5 * r2 * std::log(r2) : 0.0; }
+
+QRect PointsRasterizer::cells_around(float x, float y) const
+{
+  const float dx = (this->xmax - this->xmin) / SFLOAT(this->field.width);
+  const float dy = (this->ymax - this->ymin) / SFLOAT(this->field.height);
+
+  // cell centers within the radius (with a one cell margin)
+  int i0 = SINT(std::floor((x - this->radius - this->xmin) / dx - 0.5f));
+  int i1 = SINT(std::ceil((x + this->radius - this->xmin) / dx - 0.5f));
+  int j0 = SINT(std::floor((y - this->radius - this->ymin) / dy - 0.5f));
+  int j1 = SINT(std::ceil((y + this->radius - this->ymin) / dy - 0.5f));
+
+  return QRect(QPoint(i0, j0), QPoint(i1, j1)) &
+         QRect(0, 0, this->field.width, this->field.height);
+}
+
+void PointsRasterizer::rasterize(std::span<const float> x,
+                                 std::span<const float> y,
+                                 std::span<const float> z)
+{
+  const int n = SINT(std::min({x.size(), y.size(), z.size()}));
+
+  if (this->field.width == 0 || this->field.height == 0)
+    return;
+
+  // grid cells about the size of the support radius
+  int ni = std::clamp(SINT(std::ceil((this->xmax - this->xmin) / this->radius)), 1, 256);
+  int nj = std::clamp(SINT(std::ceil((this->ymax - this->ymin) / this->radius)), 1, 256);
+
+  this->grid.reset(this->xmin, this->xmax, this->ymin, this->ymax, ni, nj);
+
+  for (int k = 0; k < n; ++k)
+    this->grid.insert(k, x[k], y[k]);
+
+  this->use_thin_plate = false;
+
+  if (this->method == THIN_PLATE_SPLINE)
+  {
+    if (n <= TPS_MAX_POINTS && this->solve_thin_plate(x, y, z))
+      this->use_thin_plate = true;
+    else
+      Logger::log()->warn("PointsRasterizer::rasterize: thin-plate spline not "
+                          "available for {} points, falling back to inverse "
+                          "distance weighting",
+                          n);
+  }
+
+  this->rasterize_region(x, y, z, QRect(0, 0, this->field.width, this->field.height));
+}
+
+void PointsRasterizer::rasterize_region(std::span<const float> x,
+                                        std::span<const float> y,
+                                        std::span<const float> z,
+                                        const QRect           &region)
+{
+  if (region.isEmpty())
+    return;
+
+  const float dx = (this->xmax - this->xmin) / SFLOAT(this->field.width);
+  const float dy = (this->ymax - this->ymin) / SFLOAT(this->field.height);
+  const float r = this->radius;
+  const float r2 = r * r;
+  const float sigma = r / 3.f;
+  const int   n = SINT(std::min({x.size(), y.size(), z.size()}));
+
+  // thin-plate spline, global support
+  if (this->use_thin_plate)
+  {
+    const double *w = this->tps_weights.data();
+
+    parallel_for(region.top(),
+                 region.bottom() + 1,
+                 [&](int j0, int j1)
+                 {
+                   for (int j = j0; j < j1; ++j)
+                     for (int i = region.left(); i <= region.right(); ++i)
+                     {
+                       const float xc = this->xmin + (SFLOAT(i) + 0.5f) * dx;
+                       const float yc = this->ymin + (SFLOAT(j) + 0.5f) * dy;
+                       double      sum = w[n] + w[n + 1] * xc + w[n + 2] * yc;
+
+                       for (int k = 0; k < n; ++k)
+                       {
+                         double ex = x[k] - xc;
+                         double ey = y[k] - yc;
+                         sum += w[k] * tps_kernel(ex * ex + ey * ey);
+                       }
+
+                       this->field.at(i, j) = static_cast<float>(sum);
+                     }
+                 });
+    return;
+  }
+
+  // the points within the radius of a row are gathered once and sorted by
+  // x, each cell then only visits the points of a sliding window
+  struct BandPoint
+  {
+    float x;
+    float ey2;
+    int   k;
+  };
+
+  const float band_x0 = this->xmin + SFLOAT(region.left()) * dx - r;
+  const float band_x1 = this->xmin + SFLOAT(region.right() + 1) * dx + r;
+
+  parallel_for(
+      region.top(),
+      region.bottom() + 1,
+      [&](int j0, int j1)
+      {
+        const int                          nk = this->neighbors;
+        std::vector<int>                   ids;
+        std::vector<BandPoint>             band;
+        std::vector<std::pair<float, int>> nearest(static_cast<size_t>(nk)); // (d2, id)
+
+        for (int j = j0; j < j1; ++j)
+        {
+          const float yc = this->ymin + (SFLOAT(j) + 0.5f) * dy;
+
+          ids.clear();
+          band.clear();
+          this->grid.query(band_x0, yc - r, band_x1, yc + r, ids);
+
+          for (int k : ids)
+          {
+            float ey = y[k] - yc;
+            if (ey * ey < r2)
+              band.push_back({x[k], ey * ey, k});
+          }
+
+          std::sort(band.begin(),
+                    band.end(),
+                    [](const BandPoint &a, const BandPoint &b) { return a.x < b.x; });
+
+          size_t first = 0;
+
+          for (int i = region.left(); i <= region.right(); ++i)
+          {
+            const float xc = this->xmin + (SFLOAT(i) + 0.5f) * dx;
+
+            while (first < band.size() && band[first].x <= xc - r)
+              ++first;
+
+            double sum_w = 0.0;
+            double sum_wz = 0.0;
+            int    count = 0;
+
+            for (size_t q = first; q < band.size() && band[q].x < xc + r; ++q)
+            {
+              float ex = band[q].x - xc;
+              float d2 = ex * ex + band[q].ey2;
+
+              if (d2 >= r2)
+                continue;
+
+              if (this->method == GAUSSIAN_SPLATTING)
+              {
+                double w = std::exp(-0.5f * d2 / (sigma * sigma));
+                sum_w += w;
+                sum_wz += w * z[band[q].k];
+                continue;
+              }
+
+              // nearest candidates kept sorted by insertion, most points are
+              // rejected by a single comparison with the farthest one kept
+              if (count == nk && d2 >= nearest[nk - 1].first)
+                continue;
+
+              int p = count < nk ? count++ : nk - 1;
+              for (; p > 0 && nearest[p - 1].first > d2; --p)
+                nearest[p] = nearest[p - 1];
+              nearest[p] = {d2, band[q].k};
+            }
+
+            // modified Shepard weights, exact at the points
+            for (int p = 0; p < count; ++p)
+            {
+              auto [d2, k] = nearest[p];
+
+              if (d2 == 0.f)
+              {
+                sum_w = 1.0;
+                sum_wz = z[k];
+                break;
+              }
+
+              double d = std::sqrt(d2);
+              double w = (r - d) / (r * d);
+
+              sum_w += w * w;
+              sum_wz += w * w * z[k];
+            }
+
+            this->field.at(i, j) = sum_w > 0.0 ? static_cast<float>(sum_wz / sum_w)
+                                               : 0.f;
+          }
+        }
+      });
+}
+
+void PointsRasterizer::set_domain(float xmin_, float xmax_, float ymin_, float ymax_)
+{
+  this->xmin = xmin_;
+  this->xmax = xmax_;
+  this->ymin = ymin_;
+  this->ymax = ymax_;
+}
+
+void PointsRasterizer::set_method(PointsRasterization method_,
+                                  float               radius_,
+                                  int                 neighbors_)
+{
+  this->method = method_;
+  this->radius = std::max(radius_, 1e-6f);
+  this->neighbors = std::max(neighbors_, 1);
+}
+
+void PointsRasterizer::set_size(int width, int height)
+{
+  if (width != this->field.width || height != this->field.height)
+    this->field = FloatField(std::max(width, 0), std::max(height, 0));
+}
+
+// Solves the (n + 3) x (n + 3) thin-plate spline system (point weights and
+// affine part) by Gaussian elimination with partial pivoting, returns false
+// for a singular system (less than 3 points, duplicated or aligned points).
+bool PointsRasterizer::solve_thin_plate(std::span<const float> x,
+                                        std::span<const float> y,
+                                        std::span<const float> z)
+{
+  const int n = SINT(std::min({x.size(), y.size(), z.size()}));
+  const int m = n + 3;
+
+  if (n < 3)
+    return false;
+
+  // augmented matrix, m rows of m + 1 values
+  std::vector<double> a(static_cast<size_t>(m * (m + 1)), 0.0);
+  auto                at = [&](int r, int c) -> double & { return a[r * (m + 1) + c]; };
+
+  for (int r = 0; r < n; ++r)
+  {
+    for (int c = 0; c < n; ++c)
+    {
+      double ex = x[r] - x[c];
+      double ey = y[r] - y[c];
+      at(r, c) = tps_kernel(ex * ex + ey * ey);
+    }
+
+    at(r, n) = at(n, r) = 1.0;
+    at(r, n + 1) = at(n + 1, r) = x[r];
+    at(r, n + 2) = at(n + 2, r) = y[r];
+    at(r, m) = z[r];
+  }
+
+  for (int p = 0; p < m; ++p)
+  {
+    int pivot = p;
+    for (int r = p + 1; r < m; ++r)
+      if (std::abs(at(r, p)) > std::abs(at(pivot, p)))
+        pivot = r;
+
+    if (std::abs(at(pivot, p)) < 1e-12)
+      return false;
+
+    if (pivot != p)
+      for (int c = p; c <= m; ++c)
+        std::swap(at(p, c), at(pivot, c));
+
+    for (int r = p + 1; r < m; ++r)
+    {
+      double f = at(r, p) / at(p, p);
+      if (f != 0.0)
+        for (int c = p; c <= m; ++c)
+          at(r, c) -= f * at(p, c);
+    }
+  }
+
+  this->tps_weights.assign(static_cast<size_t>(m), 0.0);
+
+  for (int r = m - 1; r >= 0; --r)
+  {
+    double s = at(r, m);
+    for (int c = r + 1; c < m; ++c)
+      s -= at(r, c) * this->tps_weights[c];
+    this->tps_weights[r] = s / at(r, r);
+  }
+
+  return true;
+}
+
+QRect PointsRasterizer::update_point(std::span<const float> x,
+                                     std::span<const float> y,
+                                     std::span<const float> z,
+                                     int                    idx,
+                                     float                  x_before,
+                                     float                  y_before)
+{
+  if (this->field.width == 0 || this->field.height == 0)
+    return QRect();
+
+  this->grid.remove(idx, x_before, y_before);
+  this->grid.insert(idx, x[idx], y[idx]);
+
+  // global support, everything changes
+  if (this->use_thin_plate)
+  {
+    const QRect full = QRect(0, 0, this->field.width, this->field.height);
+
+    if (!this->solve_thin_plate(x, y, z))
+    {
+      this->rasterize(x, y, z); // falls back to IDW
+      return full;
+    }
+
+    this->rasterize_region(x, y, z, full);
+    return full;
+  }
+
+  // both neighborhoods are updated separately, their bounding box can be
+  // much larger when the point moved far
+  QRect region_before = this->cells_around(x_before, y_before);
+  QRect region_after = this->cells_around(x[idx], y[idx]);
+
+  this->rasterize_region(x, y, z, region_before);
+  if (region_after != region_before)
+    this->rasterize_region(x, y, z, region_after);
+
+  return region_before.united(region_after);
+}
+
+} // namespace qsx
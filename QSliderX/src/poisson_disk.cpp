@@ -0,0 +1,153 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "qsx/internal/poisson_disk.hpp"
+#include "qsx/internal/utils.hpp"
+
+namespace qsx
+{
+
+void poisson_disk_sampling(float               xmin,
+                           float               xmax,
+                           float               ymin,
+                           float               ymax,
+                           float               radius,
+                           std::vector<float> &x,
+                           std::vector<float> &y,
+                           uint32_t            seed,
+                           const FloatField   &density,
+                           int                 k)
+{
+  x.clear();
+  y.clear();
+
+  if (radius <= 0.f || xmax <= xmin || ymax <= ymin)
+    return;
+
+  const bool  use_density = density.width > 0 && density.height > 0;
+  const float lx = xmax - xmin;
+  const float ly = ymax - ymin;
+
+  // local minimum distance, never below 'radius'
+  auto local_radius = [&](float px, float py)
+  {
+    if (!use_density)
+      return radius;
+
+    int   i = std::clamp(SINT((px - xmin) / lx * SFLOAT(density.width)),
+                       0,
+                       density.width - 1);
+    int   j = std::clamp(SINT((py - ymin) / ly * SFLOAT(density.height)),
+                       0,
+                       density.height - 1);
+    float d = std::clamp(density.at(i, j), 1.f / 16.f, 1.f);
+    return radius / std::sqrt(d);
+  };
+
+  // background grid, cells small enough to hold at most one point, the
+  // point coordinates are stored in the cells (far away for an empty cell)
+  // to avoid an indirection in the distance checks
+  struct Cell
+  {
+    float x;
+    float y;
+  };
+
+  const float cell = radius / std::sqrt(2.f);
+  const int   ni = std::max(1, SINT(std::ceil(lx / cell)));
+  const int   nj = std::max(1, SINT(std::ceil(ly / cell)));
+  const float far = std::numeric_limits<float>::infinity();
+
+  std::vector<Cell>  grid(static_cast<size_t>(ni) * static_cast<size_t>(nj), {far, far});
+  std::vector<int>   active;
+  std::vector<float> radii; // local radius of each point
+
+  auto cell_i = [&](float px) { return std::clamp(SINT((px - xmin) / cell), 0, ni - 1); };
+  auto cell_j = [&](float py) { return std::clamp(SINT((py - ymin) / cell), 0, nj - 1); };
+
+  auto add_point = [&](float px, float py, float r)
+  {
+    int id = SINT(x.size());
+    x.push_back(px);
+    y.push_back(py);
+    radii.push_back(r);
+    active.push_back(id);
+    grid[static_cast<size_t>(cell_j(py) * ni + cell_i(px))] = {px, py};
+  };
+
+  std::mt19937                          gen(seed);
+  std::uniform_real_distribution<float> dis(0.f, 1.f);
+
+  {
+    float px = xmin + dis(gen) * lx;
+    float py = ymin + dis(gen) * ly;
+    add_point(px, py, local_radius(px, py));
+  }
+
+  while (!active.empty())
+  {
+    // random active point
+    size_t a = static_cast<size_t>(dis(gen) * SFLOAT(active.size()));
+    a = std::min(a, active.size() - 1);
+
+    const int   id = active[a];
+    const float ra = radii[id];
+    bool        found = false;
+
+    for (int n = 0; n < k && !found; ++n)
+    {
+      // candidate in the annulus [ra, 2 ra] around the active point
+      float theta = 2.f * SFLOAT(M_PI) * dis(gen);
+      float rho = ra * (1.f + dis(gen));
+      float px = x[id] + rho * std::cos(theta);
+      float py = y[id] + rho * std::sin(theta);
+
+      if (px < xmin || px >= xmax || py < ymin || py >= ymax)
+        continue;
+
+      const float r = local_radius(px, py);
+      const int   reach = SINT(std::ceil(r / cell));
+      const int   ic = cell_i(px);
+      const int   jc = cell_j(py);
+      bool        is_valid = true;
+
+      const int i0 = std::max(ic - reach, 0);
+      const int i1 = std::min(ic + reach, ni - 1);
+      const int j0 = std::max(jc - reach, 0);
+      const int j1 = std::min(jc + reach, nj - 1);
+
+      for (int j = j0; j <= j1 && is_valid; ++j)
+        for (int i = i0; i <= i1; ++i)
+        {
+          const Cell &q = grid[static_cast<size_t>(j * ni + i)];
+          float       dx = q.x - px;
+          float       dy = q.y - py;
+          if (dx * dx + dy * dy < r * r)
+          {
+            is_valid = false;
+            break;
+          }
+        }
+
+      if (is_valid)
+      {
+        add_point(px, py, r);
+        found = true;
+      }
+    }
+
+    // no room left around this point
+    if (!found)
+    {
+      active[a] = active.back();
+      active.pop_back();
+    }
+  }
+}
+
+} // namespace qsx
@@ -0,0 +1,215 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <utility>
+
+#include "qsx/internal/polyline.hpp"
+#include "qsx/internal/utils.hpp"
+
+namespace qsx
+{
+
+std::vector<int> simplify_rdp(std::span<const float> x,
+                              std::span<const float> y,
+                              float                  tolerance)
+{
+  const int n = SINT(std::min(x.size(), y.size()));
+
+  if (n < 3)
+  {
+    std::vector<int> ids(static_cast<size_t>(n));
+    for (int k = 0; k < n; ++k)
+      ids[k] = k;
+    return ids;
+  }
+
+  std::vector<char> keep(static_cast<size_t>(n), 0);
+  keep.front() = 1;
+  keep.back() = 1;
+
+  // explicit stack of [first, last] ranges to avoid deep recursions on
+  // long, noisy paths
+  std::vector<std::pair<int, int>> stack = {{0, n - 1}};
+  const float                      tol2 = tolerance * tolerance;
+
+  while (!stack.empty())
+  {
+    auto [first, last] = stack.back();
+    stack.pop_back();
+
+    float ax = x[first];
+    float ay = y[first];
+    float dx = x[last] - ax;
+    float dy = y[last] - ay;
+    float len2 = dx * dx + dy * dy;
+
+    // farthest vertex from the segment [first, last]
+    int   kmax = -1;
+    float dmax = tol2;
+
+    for (int k = first + 1; k < last; ++k)
+    {
+      float t = len2 > 0.f ? std::clamp(((x[k] - ax) * dx + (y[k] - ay) * dy) / len2,
+                                        0.f,
+                                        1.f)
+                           : 0.f;
+      float ex = ax + t * dx - x[k];
+      float ey = ay + t * dy - y[k];
+      float d2 = ex * ex + ey * ey;
+
+      if (d2 > dmax)
+      {
+        dmax = d2;
+        kmax = k;
+      }
+    }
+
+    if (kmax >= 0)
+    {
+      keep[kmax] = 1;
+      stack.push_back({first, kmax});
+      stack.push_back({kmax, last});
+    }
+  }
+
+  std::vector<int> ids;
+  for (int k = 0; k < n; ++k)
+    if (keep[k])
+      ids.push_back(k);
+
+  return ids;
+}
+
+std::vector<int> simplify_visvalingam(std::span<const float> x,
+                                      std::span<const float> y,
+                                      float                  min_area)
+{
+  const int n = SINT(std::min(x.size(), y.size()));
+
+  std::vector<int>  prev(static_cast<size_t>(n));
+  std::vector<int>  next(static_cast<size_t>(n));
+  std::vector<char> removed(static_cast<size_t>(n), 0);
+
+  for (int k = 0; k < n; ++k)
+  {
+    prev[k] = k - 1;
+    next[k] = k + 1;
+  }
+
+  auto area = [&](int k)
+  {
+    int   a = prev[k];
+    int   b = next[k];
+    float cross = (x[a] - x[k]) * (y[b] - y[k]) - (x[b] - x[k]) * (y[a] - y[k]);
+    return 0.5f * std::abs(cross);
+  };
+
+  std::vector<float> current_area(static_cast<size_t>(n), 0.f);
+
+  // min-heap of (area, vertex), entries made stale by a neighbor removal are
+  // skipped when popped
+  using Entry = std::pair<float, int>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+
+  for (int k = 1; k < n - 1; ++k)
+  {
+    current_area[k] = area(k);
+    heap.push({current_area[k], k});
+  }
+
+  while (!heap.empty())
+  {
+    auto [a, k] = heap.top();
+    heap.pop();
+
+    if (removed[k] || a != current_area[k])
+      continue;
+
+    if (a > min_area)
+      break;
+
+    removed[k] = 1;
+    next[prev[k]] = next[k];
+    prev[next[k]] = prev[k];
+
+    for (int q : {prev[k], next[k]})
+      if (q > 0 && q < n - 1)
+      {
+        current_area[q] = area(q);
+        heap.push({current_area[q], q});
+      }
+  }
+
+  std::vector<int> ids;
+  for (int k = 0; k < n; ++k)
+    if (!removed[k])
+      ids.push_back(k);
+
+  return ids;
+}
+
+void resample_arc_length(std::span<const float> x,
+                         std::span<const float> y,
+                         std::span<const float> z,
+                         int                    n,
+                         std::vector<float>    &x_out,
+                         std::vector<float>    &y_out,
+                         std::vector<float>    &z_out)
+{
+  const int m = SINT(std::min({x.size(), y.size(), z.size()}));
+
+  x_out.clear();
+  y_out.clear();
+  z_out.clear();
+
+  if (m == 0 || n <= 0)
+    return;
+
+  x_out.resize(static_cast<size_t>(n));
+  y_out.resize(static_cast<size_t>(n));
+  z_out.resize(static_cast<size_t>(n));
+
+  // cumulative arc length
+  std::vector<float> s(static_cast<size_t>(m), 0.f);
+  for (int k = 1; k < m; ++k)
+    s[k] = s[k - 1] + std::hypot(x[k] - x[k - 1], y[k] - y[k - 1]);
+
+  const float length = s.back();
+
+  if (m == 1 || n == 1 || length <= 0.f)
+  {
+    std::fill(x_out.begin(), x_out.end(), x[0]);
+    std::fill(y_out.begin(), y_out.end(), y[0]);
+    std::fill(z_out.begin(), z_out.end(), z[0]);
+    return;
+  }
+
+  // the targets are increasing, single sweep over the segments
+  int k = 0;
+
+  for (int r = 0; r < n; ++r)
+  {
+    float t = length * SFLOAT(r) / SFLOAT(n - 1);
+
+    while (k < m - 2 && s[k + 1] < t)
+      ++k;
+
+    float ds = s[k + 1] - s[k];
+    float u = ds > 0.f ? std::clamp((t - s[k]) / ds, 0.f, 1.f) : 0.f;
+
+    x_out[r] = x[k] + u * (x[k + 1] - x[k]);
+    y_out[r] = y[k] + u * (y[k + 1] - y[k]);
+    z_out[r] = z[k] + u * (z[k + 1] - z[k]);
+  }
+
+  // exact end points
+  x_out.back() = x[m - 1];
+  y_out.back() = y[m - 1];
+  z_out.back() = z[m - 1];
+}
+
+} // namespace qsx
@@ -0,0 +1,98 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+
+#include "qsx/internal/uniform_grid.hpp"
+#include "qsx/internal/utils.hpp"
+
+namespace qsx
+{
+
+int UniformGrid::cell_i(float x) const
+{
+  float r = (x - this->xmin) / (this->xmax - this->xmin);
+  return std::clamp(SINT(r * SFLOAT(this->ni)), 0, this->ni - 1);
+}
+
+int UniformGrid::cell_j(float y) const
+{
+  float r = (y - this->ymin) / (this->ymax - this->ymin);
+  return std::clamp(SINT(r * SFLOAT(this->nj)), 0, this->nj - 1);
+}
+
+void UniformGrid::clear()
+{
+  for (auto &c : this->cells)
+    c.clear();
+}
+
+float UniformGrid::get_cell_size() const
+{
+  if (this->ni == 0 || this->nj == 0)
+    return 0.f;
+
+  return std::max((this->xmax - this->xmin) / SFLOAT(this->ni),
+                  (this->ymax - this->ymin) / SFLOAT(this->nj));
+}
+
+void UniformGrid::insert(int id, float x0, float y0, float x1, float y1)
+{
+  if (this->cells.empty())
+    return;
+
+  for (int j = this->cell_j(y0); j <= this->cell_j(y1); ++j)
+    for (int i = this->cell_i(x0); i <= this->cell_i(x1); ++i)
+      this->cells[static_cast<size_t>(j * this->ni + i)].push_back(id);
+}
+
+void UniformGrid::query(float x0, float y0, float x1, float y1, std::vector<int> &ids) const
+{
+  if (this->cells.empty())
+    return;
+
+  for (int j = this->cell_j(y0); j <= this->cell_j(y1); ++j)
+    for (int i = this->cell_i(x0); i <= this->cell_i(x1); ++i)
+    {
+      const auto &c = this->cells[static_cast<size_t>(j * this->ni + i)];
+      ids.insert(ids.end(), c.begin(), c.end());
+    }
+}
+
+bool UniformGrid::query_covers_grid(float x0, float y0, float x1, float y1) const
+{
+  return x0 <= this->xmin && y0 <= this->ymin && x1 >= this->xmax && y1 >= this->ymax;
+}
+
+void UniformGrid::remove(int id, float x0, float y0, float x1, float y1)
+{
+  if (this->cells.empty())
+    return;
+
+  for (int j = this->cell_j(y0); j <= this->cell_j(y1); ++j)
+    for (int i = this->cell_i(x0); i <= this->cell_i(x1); ++i)
+    {
+      auto &c = this->cells[static_cast<size_t>(j * this->ni + i)];
+      auto  it = std::find(c.begin(), c.end(), id);
+
+      if (it != c.end())
+      {
+        *it = c.back();
+        c.pop_back();
+      }
+    }
+}
+
+void UniformGrid::reset(float xmin_, float xmax_, float ymin_, float ymax_, int ni_, int nj_)
+{
+  this->xmin = xmin_;
+  this->xmax = xmax_ > xmin_ ? xmax_ : xmin_ + 1.f;
+  this->ymin = ymin_;
+  this->ymax = ymax_ > ymin_ ? ymax_ : ymin_ + 1.f;
+  this->ni = std::max(1, ni_);
+  this->nj = std::max(1, nj_);
+
+  this->cells.assign(static_cast<size_t>(this->ni * this->nj), {});
+}
+
+} // namespace qsx
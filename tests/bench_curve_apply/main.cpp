@@ -0,0 +1,219 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <QApplication>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "qsx/config.hpp"
+#include "qsx/curve_editor.hpp"
+
+// CurveEditor::apply and apply_interleaved against their baked tables and a
+// plain memcpy of the same buffer (a 4k RGBA float image), exits with a
+// non-zero code when a check fails.
+//
+// usage: bench_curve_apply [repeat count, default 5]
+
+static constexpr int   WIDTH = 3840;
+static constexpr int   HEIGHT = 2160;
+static constexpr float TOLERANCE = 1e-6f; // same table, same lerp
+static constexpr float TOLERANCE_COMPOSED = 1e-4f; // master table vs exact master
+
+static int failures = 0;
+
+static void check(bool ok, const std::string &what)
+{
+  if (!ok)
+  {
+    std::cout << "FAILED: " << what << "\n";
+    ++failures;
+  }
+}
+
+// best of 'repeat' runs
+template <typename F> static double time_ms(int repeat, F &&fct)
+{
+  double best = std::numeric_limits<double>::max();
+
+  for (int r = 0; r < repeat; ++r)
+  {
+    auto t0 = std::chrono::steady_clock::now();
+    fct();
+    auto t1 = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+  }
+
+  return best;
+}
+
+// table lookup as documented for CurveEditor::apply, clamped input, NaN
+// mapped to the first entry
+static float lerp_table(const std::vector<float> &lut, float v)
+{
+  const int m = static_cast<int>(lut.size());
+  float     t = std::min(std::max(0.f, v), 1.f) * static_cast<float>(m - 1);
+  int       q = std::min(static_cast<int>(t), m - 2);
+  float     f = t - static_cast<float>(q);
+
+  return lut[q] + f * (lut[q + 1] - lut[q]);
+}
+
+// RGB or RGBA curves: the color channels composed with the master curve, the
+// alpha one left out of it
+static void check_interleaved(qsx::CurveChannels channels, const std::string &name)
+{
+  const int  k = channels == qsx::CHANNELS_RGBA ? 4 : 3;
+  const int  n = QSX_CONFIG->curve.lut_size;
+  const auto nk = static_cast<size_t>(n * k);
+
+  qsx::CurveEditor ce;
+  ce.set_channels(channels);
+  ce.set_control_points({{0.f, 0.2f}, {0.5f, 0.7f}, {1.f, 0.8f}}, 0); // master
+  ce.set_control_points({{0.f, 0.f}, {0.4f, 0.6f}, {1.f, 1.f}}, 1);
+  ce.set_control_points({{0.f, 0.1f}, {0.7f, 0.3f}, {1.f, 0.9f}}, 2);
+  ce.set_control_points({{0.f, 0.3f}, {1.f, 0.5f}}, 3);
+
+  check(ce.get_channel_count() == k + 1, name + ": curve count");
+
+  // the table grid, every input value right on an entry
+  std::vector<float> in(nk), out(nk);
+
+  for (int i = 0; i < n; ++i)
+    for (int c = 0; c < k; ++c)
+      in[i * k + c] = static_cast<float>(i) / static_cast<float>(n - 1);
+
+  const std::vector<float> lut = ce.bake_lut_interleaved(n);
+
+  ce.apply_interleaved(in, out);
+
+  float err = 0.f;
+  for (size_t i = 0; i < nk; ++i)
+    err = std::max(err, std::abs(out[i] - lut[i]));
+
+  std::cout << name << ": max abs error vs bake_lut_interleaved " << err << "\n";
+  check(lut.size() == nk, name + ": bake_lut_interleaved size");
+  check(err <= TOLERANCE_COMPOSED, name + ": apply_interleaved vs bake_lut_interleaved");
+
+  if (k < 4)
+    return;
+
+  // alpha passthrough, the alpha values only go through the alpha curve table
+  // and are unchanged by a new master curve
+  std::mt19937                          gen(2);
+  std::uniform_real_distribution<float> dis(0.f, 1.f);
+
+  for (auto &v : in)
+    v = dis(gen);
+
+  ce.set_control_points({{0.f, 1.f}, {0.5f, 0.2f}, {1.f, 0.6f}}, 4);
+  ce.apply_interleaved(in, out);
+
+  const std::vector<float> lut_alpha = ce.bake_lut(n, 4);
+
+  float err_alpha = 0.f;
+  for (size_t i = 3; i < nk; i += 4)
+    err_alpha = std::max(err_alpha, std::abs(out[i] - lerp_table(lut_alpha, in[i])));
+
+  check(err_alpha <= TOLERANCE, name + ": alpha curve vs bake_lut");
+
+  std::vector<float> out_master(nk);
+
+  ce.set_control_points({{0.f, 0.9f}, {1.f, 0.f}}, 0);
+  ce.apply_interleaved(in, out_master);
+
+  bool is_same_alpha = true;
+  bool is_same_color = true;
+
+  for (size_t i = 0; i < nk; ++i)
+    if (i % 4 == 3)
+      is_same_alpha = is_same_alpha && out_master[i] == out[i];
+    else
+      is_same_color = is_same_color && out_master[i] == out[i];
+
+  check(is_same_alpha, name + ": alpha passthrough, master curve skipped");
+  check(!is_same_color, name + ": master curve applied to the colors");
+}
+
+static void report(const std::string &name, double ms, double ms_memcpy, size_t bytes)
+{
+  std::cout << name << ": " << ms << " ms, "
+            << static_cast<double>(bytes) / (ms * 1e6) << " GB/s, "
+            << ms / ms_memcpy << "x memcpy\n";
+}
+
+int main(int argc, char *argv[])
+{
+  qputenv("QT_QPA_PLATFORM", "offscreen");
+  QApplication app(argc, argv);
+
+  const int repeat = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+
+  const size_t count = static_cast<size_t>(WIDTH) * HEIGHT * 4;
+  const size_t bytes = count * sizeof(float);
+
+  // values mostly in [0, 1], a few out of range and NaN
+  std::vector<float> in(count), out(count);
+
+  std::mt19937                          gen(1);
+  std::uniform_real_distribution<float> dis(-0.05f, 1.05f);
+
+  for (auto &v : in)
+    v = dis(gen);
+
+  in[0] = std::numeric_limits<float>::quiet_NaN();
+  in[1] = -std::numeric_limits<float>::infinity();
+  in[2] = std::numeric_limits<float>::infinity();
+
+  qsx::CurveEditor ce;
+  ce.set_control_points({{0.f, 0.1f}, {0.3f, 0.6f}, {0.6f, 0.4f}, {1.f, 0.9f}});
+
+  // --- single curve, against the baked table
+
+  const std::vector<float> lut = ce.bake_lut(QSX_CONFIG->curve.lut_size);
+
+  ce.apply(in, out);
+
+  float err = 0.f;
+  for (size_t i = 0; i < count; ++i)
+    err = std::max(err, std::abs(out[i] - lerp_table(lut, in[i])));
+
+  std::cout << "apply: max abs error vs bake_lut + lerp " << err << "\n";
+  check(err <= TOLERANCE, "apply vs bake_lut + lerp");
+  check(out[0] == lut.front(), "apply, NaN mapped to the first entry");
+
+  // --- interleaved, against the composed tables
+
+  check_interleaved(qsx::CHANNELS_RGB, "RGB");
+  check_interleaved(qsx::CHANNELS_RGBA, "RGBA");
+
+  // --- timings, the same bytes read and written
+
+  double ms_memcpy = time_ms(repeat,
+                             [&]() { std::memcpy(out.data(), in.data(), bytes); });
+  double ms_apply = time_ms(repeat, [&]() { ce.apply(in, out); });
+
+  ce.set_channels(qsx::CHANNELS_RGB);
+  double ms_rgb = time_ms(repeat, [&]() { ce.apply_interleaved(in, out); });
+
+  ce.set_channels(qsx::CHANNELS_RGBA);
+  double ms_rgba = time_ms(repeat, [&]() { ce.apply_interleaved(in, out); });
+
+  report("memcpy                 ", ms_memcpy, ms_memcpy, bytes);
+  report("apply                  ", ms_apply, ms_memcpy, bytes);
+  report("apply_interleaved, RGB ", ms_rgb, ms_memcpy, bytes);
+  report("apply_interleaved, RGBA", ms_rgba, ms_memcpy, bytes);
+
+  std::cout << (failures ? "FAILED, " + std::to_string(failures) + " check(s)" : "OK")
+            << "\n";
+
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
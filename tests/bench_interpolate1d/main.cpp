@@ -0,0 +1,258 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "qsx/internal/interpolate1d.hpp"
+#include "qsx/internal/piecewise_cubic.hpp"
+
+// Accuracy of the native engine of Interpolator1D against the GSL one and
+// timings of both engines, exits with a non-zero code when a check fails.
+//
+// usage: bench_interpolate1d [value count, default 1e8]
+
+static constexpr float TOLERANCE = 1e-4f; // native (float) vs GSL (double)
+static constexpr int   KNOT_COUNT = 32;
+static constexpr int   DENSE_COUNT = 1 << 20;
+
+static int failures = 0;
+
+static void check(bool ok, const std::string &what)
+{
+  if (!ok)
+  {
+    std::cout << "FAILED: " << what << "\n";
+    ++failures;
+  }
+}
+
+// increasing knots with uneven gaps (some segments much shorter than others,
+// several per grid cell), values in [0, 1]
+static void random_knots(int                 n,
+                         uint32_t            seed,
+                         bool                monotonic,
+                         std::vector<float> &x,
+                         std::vector<float> &y)
+{
+  std::mt19937                          gen(seed);
+  std::uniform_real_distribution<float> dis(0.f, 1.f);
+
+  x.resize(static_cast<size_t>(n));
+  y.resize(static_cast<size_t>(n));
+
+  float xk = 0.f;
+  for (int k = 0; k < n; ++k)
+  {
+    x[k] = xk;
+    xk += 0.01f + dis(gen) * dis(gen) * dis(gen);
+    y[k] = dis(gen);
+  }
+
+  // rescaled to [0, 1]
+  for (auto &v : x)
+    v /= x.back();
+
+  if (monotonic)
+    std::sort(y.begin(), y.end());
+}
+
+template <typename F> static double time_ms(F &&fct)
+{
+  auto t0 = std::chrono::steady_clock::now();
+  fct();
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+static void check_accuracy(qsx::InterpolationMethod1D method, const std::string &name)
+{
+  std::vector<float> x, y;
+  random_knots(KNOT_COUNT, 1, method == qsx::STEFFEN, x, y);
+
+  qsx::Interpolator1D gsl(x, y, method, qsx::ENGINE_GSL);
+  qsx::Interpolator1D native(x, y, method, qsx::ENGINE_NATIVE);
+
+  check(native.get_engine() == qsx::ENGINE_NATIVE, name + ": native engine used");
+
+  // dense grid, beyond the knots range on both sides
+  std::vector<float> q(DENSE_COUNT), y_gsl(DENSE_COUNT), y_native(DENSE_COUNT);
+
+  for (int i = 0; i < DENSE_COUNT; ++i)
+    q[i] = -0.1f + 1.2f * static_cast<float>(i) / static_cast<float>(DENSE_COUNT - 1);
+
+  gsl.evaluate(q, y_gsl);
+  native.evaluate(q, y_native);
+
+  float err = 0.f;
+  float err_single = 0.f; // interpolate() vs evaluate()
+  bool  is_monotonic = true;
+
+  for (int i = 0; i < DENSE_COUNT; ++i)
+  {
+    err = std::max(err, std::abs(y_native[i] - y_gsl[i]));
+    if (i > 0 && y_native[i] < y_native[i - 1])
+      is_monotonic = false;
+  }
+
+  for (int i = 0; i < DENSE_COUNT; i += 97)
+  {
+    err_single = std::max(err_single, std::abs(native(q[i]) - y_native[i]));
+    err_single = std::max(err_single, std::abs(gsl(q[i]) - y_gsl[i]));
+  }
+
+  std::cout << name << ": max abs error native vs GSL " << err << "\n";
+
+  check(err <= TOLERANCE, name + ": native vs GSL error");
+  check(err_single <= TOLERANCE, name + ": interpolate() vs evaluate()");
+
+  if (method == qsx::STEFFEN)
+    check(is_monotonic, name + ": monotonic output");
+
+  // boundaries, the knots themselves and clamping outside of them
+  const float inf = std::numeric_limits<float>::infinity();
+
+  std::vector<float> b = {x.front(), x.back(), x.front() - 1.f, x.back() + 1.f, -inf, inf};
+  b.insert(b.end(), x.begin(), x.end());
+
+  std::vector<float> b_gsl(b.size()), b_native(b.size());
+  gsl.evaluate(b, b_gsl);
+  native.evaluate(b, b_native);
+
+  float err_boundary = 0.f;
+  for (size_t i = 0; i < b.size(); ++i)
+  {
+    err_boundary = std::max(err_boundary, std::abs(b_native[i] - b_gsl[i]));
+    err_boundary = std::max(err_boundary, std::abs(native(b[i]) - b_gsl[i]));
+  }
+
+  for (size_t k = 0; k < x.size(); ++k)
+    err_boundary = std::max(err_boundary, std::abs(native(x[k]) - y[k]));
+
+  check(err_boundary <= TOLERANCE, name + ": boundary values");
+
+  // NaN propagated by both engines
+  const float        nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<float> v_nan = {nan, 0.5f, nan}, r_gsl(3), r_native(3);
+
+  gsl.evaluate(v_nan, r_gsl);
+  native.evaluate(v_nan, r_native);
+
+  check(std::isnan(native(nan)) && std::isnan(gsl(nan)), name + ": NaN, interpolate()");
+  check(std::isnan(r_native[0]) && std::isnan(r_native[2]) && std::isnan(r_gsl[0]) &&
+            std::isnan(r_gsl[2]) && !std::isnan(r_native[1]),
+        name + ": NaN, evaluate()");
+}
+
+// grid lookup against a binary search, random and clustered knots
+static void check_find_segment()
+{
+  std::mt19937                          gen(2);
+  std::uniform_real_distribution<float> dis(0.f, 1.f);
+
+  for (int n : {2, 3, 5, KNOT_COUNT, 1000})
+  {
+    std::vector<float> x, y;
+    random_knots(n, static_cast<uint32_t>(n), false, x, y);
+
+    qsx::PiecewiseCubic pc;
+    pc.set_linear(x, y);
+
+    int mismatches = 0;
+
+    for (int i = 0; i < DENSE_COUNT; ++i)
+    {
+      // also hit the knots exactly
+      float v = i % 7 == 0 ? x[static_cast<size_t>(i) % x.size()] : dis(gen);
+
+      int k = static_cast<int>(std::upper_bound(x.begin(), x.end(), v) - x.begin()) - 1;
+      k = std::clamp(k, 0, n - 2);
+
+      if (k != pc.find_segment(v))
+        ++mismatches;
+    }
+
+    check(mismatches == 0,
+          "find_segment vs upper_bound, " + std::to_string(n) + " knots, " +
+              std::to_string(mismatches) + " mismatches");
+  }
+}
+
+static void bench(qsx::InterpolationMethod1D method,
+                  const std::string         &name,
+                  const std::vector<float>  &values,
+                  std::vector<float>        &out)
+{
+  std::vector<float> x, y;
+  random_knots(KNOT_COUNT, 1, method == qsx::STEFFEN, x, y);
+
+  for (auto engine : {qsx::ENGINE_GSL, qsx::ENGINE_NATIVE})
+  {
+    qsx::Interpolator1D interp(x, y, method, engine);
+
+    double ms_single = time_ms(
+        [&]()
+        {
+          for (size_t i = 0; i < values.size(); ++i)
+            out[i] = interp.interpolate(values[i]);
+        });
+
+    double ms_batch = time_ms([&]() { interp.evaluate(values, out); });
+
+    // the output is used, the loops are not optimized away
+    double sum = 0.0;
+    for (size_t i = 0; i < out.size(); i += 4096)
+      sum += static_cast<double>(out[i]);
+
+    const double mvalues = static_cast<double>(values.size()) * 1e-6;
+
+    std::cout << name << (engine == qsx::ENGINE_GSL ? " GSL   " : " native")
+              << ": interpolate() " << ms_single << " ms (" << mvalues / ms_single * 1e3
+              << " Mvalues/s), evaluate(span) " << ms_batch << " ms ("
+              << mvalues / ms_batch * 1e3 << " Mvalues/s) [" << sum << "]\n";
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const size_t count = argc > 1 ? std::stoull(argv[1]) : size_t(100000000);
+
+  const std::vector<std::pair<qsx::InterpolationMethod1D, std::string>> methods = {
+      {qsx::LINEAR, "linear"},
+      {qsx::CUBIC, "cubic"},
+      {qsx::AKIMA, "akima"},
+      {qsx::STEFFEN, "steffen"},
+  };
+
+  // --- accuracy
+
+  for (auto &[method, name] : methods)
+    check_accuracy(method, name);
+
+  check_find_segment();
+
+  // --- timings, random order as when applying a curve to an image
+
+  std::vector<float> values(count), out(count);
+
+  std::mt19937                          gen(3);
+  std::uniform_real_distribution<float> dis(0.f, 1.f);
+  for (auto &v : values)
+    v = dis(gen);
+
+  for (auto &[method, name] : methods)
+    bench(method, name, values, out);
+
+  std::cout << (failures ? "FAILED, " + std::to_string(failures) + " check(s)" : "OK")
+            << "\n";
+
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,282 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <QApplication>
+#include <QHoverEvent>
+#include <QMouseEvent>
+#include <QWheelEvent>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "qsx/canvas_points.hpp"
+#include "qsx/config.hpp"
+
+// CanvasPoints undo/redo history: mouse and programmatic edits undone then
+// redone step by step against snapshots of the points, and eviction of the
+// oldest edits beyond the count and memory budgets. Exits with a non-zero code
+// when a check fails.
+
+static constexpr int SIZE = 256; // widget size, the points area covers all of it
+
+static int failures = 0;
+
+static void check(bool ok, const std::string &what)
+{
+  if (!ok)
+  {
+    std::cout << "FAILED: " << what << "\n";
+    ++failures;
+  }
+}
+
+struct Points
+{
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> z;
+
+  bool operator==(const Points &other) const = default;
+};
+
+static Points snapshot(const qsx::CanvasPoints &cp)
+{
+  return {cp.get_points_x(), cp.get_points_y(), cp.get_points_z()};
+}
+
+// widget position of a point of the [0, 1] x [0, 1] canvas
+static QPoint to_widget(float x, float y)
+{
+  return QPoint(static_cast<int>(x * SIZE), static_cast<int>((1.f - y) * SIZE));
+}
+
+static void hover(qsx::CanvasPoints &cp, QPoint pos)
+{
+  QHoverEvent event(QEvent::HoverMove, pos, pos, pos);
+  QApplication::sendEvent(&cp, &event);
+}
+
+static void mouse(qsx::CanvasPoints &cp,
+                  QEvent::Type       type,
+                  QPoint             pos,
+                  Qt::MouseButton    button)
+{
+  QMouseEvent event(type, pos, pos, button, button, Qt::NoModifier);
+  QApplication::sendEvent(&cp, &event);
+}
+
+static void wheel(qsx::CanvasPoints &cp, QPoint pos, int delta)
+{
+  QWheelEvent event(pos,
+                    pos,
+                    QPoint(),
+                    QPoint(0, delta),
+                    Qt::NoButton,
+                    Qt::NoModifier,
+                    Qt::NoScrollPhase,
+                    false);
+  QApplication::sendEvent(&cp, &event);
+}
+
+// n x n grid, row by row, far enough apart for the hovering to be unambiguous
+// with n = 4
+static void set_grid(qsx::CanvasPoints &cp, int n)
+{
+  std::vector<float> x, y, z;
+
+  for (int j = 0; j < n; ++j)
+    for (int i = 0; i < n; ++i)
+    {
+      x.push_back(0.2f + 0.6f * static_cast<float>(i) / static_cast<float>(n - 1));
+      y.push_back(0.2f + 0.6f * static_cast<float>(j) / static_cast<float>(n - 1));
+      z.push_back(0.5f);
+    }
+
+  cp.set_points(x, y, z);
+}
+
+// every kind of edit, undone down to the original points then redone up to
+// the final ones
+static void check_undo_redo(qsx::CanvasPoints &cp)
+{
+  set_grid(cp, 4);
+
+  std::vector<Points>      states = {snapshot(cp)};
+  std::vector<std::string> names;
+
+  auto record = [&](const std::string &name)
+  {
+    states.push_back(snapshot(cp));
+    names.push_back(name);
+    check(states.back() != states[states.size() - 2], name + ": points changed");
+  };
+
+  check(!cp.undo(), "empty history after set_points");
+
+  // insertion at the end, free points
+  mouse(cp, QEvent::MouseButtonDblClick, to_widget(0.1f, 0.9f), Qt::LeftButton);
+  record("insert");
+  check(states.back().x.size() == 17 && states.back().z.back() == 1.f,
+        "insert: new point");
+
+  // drag of a single point
+  QPoint pos = to_widget(0.4f, 0.4f);
+  hover(cp, pos);
+  mouse(cp, QEvent::MouseButtonPress, pos, Qt::LeftButton);
+  mouse(cp, QEvent::MouseMove, pos + QPoint(20, -10), Qt::LeftButton);
+  mouse(cp, QEvent::MouseButtonRelease, pos + QPoint(20, -10), Qt::LeftButton);
+  record("move");
+
+  // z value
+  pos = to_widget(0.6f, 0.4f);
+  hover(cp, pos);
+  wheel(cp, pos, 120);
+  record("wheel");
+
+  // removal
+  pos = to_widget(0.6f, 0.2f);
+  hover(cp, pos);
+  mouse(cp, QEvent::MouseButtonPress, pos, Qt::RightButton);
+  record("remove");
+  check(states.back().x.size() == 16, "remove: point count");
+
+  // selection transform
+  cp.select_in_rect(0.3f, 0.3f, 0.7f, 0.7f);
+  check(cp.get_selection().size() == 4, "transform: selection");
+  cp.transform_selection(0.05f, -0.02f, 1.1f, 0.3f);
+  record("transform");
+
+  // insertion within the path
+  cp.set_connected_points(true);
+  const Points p = states.back();
+  mouse(cp,
+        QEvent::MouseButtonDblClick,
+        to_widget(0.5f * (p.x[0] + p.x[1]), 0.5f * (p.y[0] + p.y[1])),
+        Qt::LeftButton);
+  record("path insert");
+  check(states.back().x.size() == 17 && states.back().x[1] > states.back().x[0] &&
+            states.back().x[1] < states.back().x[2],
+        "path insert: inserted between the segment ends");
+
+  // path edits, whole arrays
+  cp.simplify_path(0.05f);
+  record("simplify");
+  check(states.back().x.size() < 17, "simplify: point count");
+
+  cp.resample_path(12);
+  record("resample");
+
+  // undo all, each step back to the previous state
+  for (size_t k = names.size(); k-- > 0;)
+  {
+    check(cp.undo(), "undo " + names[k]);
+    check(snapshot(cp) == states[k], "undo " + names[k] + ": points restored");
+  }
+
+  check(!cp.undo(), "undo past the oldest edit");
+  check(snapshot(cp) == states.front(), "undo all: original points");
+
+  // redo all
+  for (size_t k = 0; k < names.size(); ++k)
+  {
+    check(cp.redo(), "redo " + names[k]);
+    check(snapshot(cp) == states[k + 1], "redo " + names[k] + ": points restored");
+  }
+
+  check(!cp.redo(), "redo past the newest edit");
+  check(snapshot(cp) == states.back(), "redo all: final points");
+
+  // a new edit drops the redo history
+  cp.undo();
+  cp.select_in_rect(0.f, 0.f, 1.f, 1.f);
+  cp.transform_selection(0.f, 0.f, 0.9f);
+  check(!cp.redo(), "redo history dropped by a new edit");
+
+  cp.set_connected_points(false);
+}
+
+// 'count' rotations of all the points, returns the states before and after
+static std::vector<Points> rotate_all(qsx::CanvasPoints &cp, size_t count)
+{
+  std::vector<Points> states = {snapshot(cp)};
+
+  cp.select_in_rect(0.f, 0.f, 1.f, 1.f);
+
+  for (size_t k = 0; k < count; ++k)
+  {
+    cp.transform_selection(0.f, 0.f, 1.f, 0.05f);
+    states.push_back(snapshot(cp));
+  }
+
+  return states;
+}
+
+// counts the undo steps left, back to the oldest one kept
+static size_t undo_all(qsx::CanvasPoints &cp)
+{
+  size_t count = 0;
+
+  while (cp.undo())
+    ++count;
+
+  return count;
+}
+
+static void check_eviction(qsx::CanvasPoints &cp)
+{
+  // edit count
+  const size_t max_history = QSX_CONFIG->global.max_history;
+  const size_t extra = 3;
+
+  set_grid(cp, 4);
+  std::vector<Points> states = rotate_all(cp, max_history + extra);
+
+  check(undo_all(cp) == max_history, "count budget: undo steps");
+  check(snapshot(cp) == states[extra], "count budget: oldest edits dropped");
+
+  // memory, each rotation stores the id and the x, y, z values of the n x n
+  // points (16 bytes each) plus a small header: two fit, not three
+  const size_t budget = QSX_CONFIG->canvas.history_max_bytes;
+  const int    n = 64;
+  const size_t op_bytes = 16 * static_cast<size_t>(n * n);
+
+  QSX_CONFIG->canvas.history_max_bytes = op_bytes * 5 / 2;
+
+  set_grid(cp, n);
+  states = rotate_all(cp, 5);
+
+  check(undo_all(cp) == 2, "memory budget: undo steps");
+  check(snapshot(cp) == states[3], "memory budget: oldest edits dropped");
+
+  // an edit larger than the whole budget is not kept
+  QSX_CONFIG->canvas.history_max_bytes = op_bytes / 2;
+
+  set_grid(cp, n);
+  rotate_all(cp, 1);
+
+  check(undo_all(cp) == 0, "memory budget: edit larger than the budget");
+
+  QSX_CONFIG->canvas.history_max_bytes = budget;
+}
+
+int main(int argc, char *argv[])
+{
+  qputenv("QT_QPA_PLATFORM", "offscreen");
+  QApplication app(argc, argv);
+
+  qsx::CanvasPoints cp("history");
+  cp.resize(SIZE, SIZE);
+  cp.show();
+
+  check(cp.width() == SIZE && cp.height() == SIZE, "widget size");
+
+  check_undo_redo(cp);
+  check_eviction(cp);
+
+  std::cout << (failures ? "FAILED, " + std::to_string(failures) + " check(s)" : "OK")
+            << "\n";
+
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "qsx/internal/histogram.hpp"
+
+// Parallel compute_histogram against a serial count, on a known distribution,
+// random values partly outside of [0, 1], special values and an empty span.
+// Exits with a non-zero code when a check fails.
+
+static constexpr int    NBINS = 64;
+static constexpr size_t COUNT = 10000000; // many blocks per thread
+
+static int failures = 0;
+
+static void check(bool ok, const std::string &what)
+{
+  if (!ok)
+  {
+    std::cout << "FAILED: " << what << "\n";
+    ++failures;
+  }
+}
+
+static std::vector<uint64_t> serial_histogram(const std::vector<float> &data, int nbins)
+{
+  std::vector<uint64_t> bins(static_cast<size_t>(nbins), 0);
+
+  for (float v : data)
+    if (v >= 0.f && v <= 1.f)
+      ++bins[static_cast<size_t>(std::min(static_cast<int>(v * static_cast<float>(nbins)),
+                                          nbins - 1))];
+
+  return bins;
+}
+
+int main()
+{
+  const std::atomic<bool> no_cancel = false;
+
+  // known distribution, the same count in every bin (value at the bin
+  // centers)
+  {
+    std::vector<float> data(COUNT);
+
+    for (size_t i = 0; i < COUNT; ++i)
+      data[i] = (static_cast<float>(i % NBINS) + 0.5f) / static_cast<float>(NBINS);
+
+    std::vector<uint64_t> bins = qsx::compute_histogram(data, NBINS, no_cancel);
+
+    check(bins.size() == NBINS, "uniform: bin count");
+    check(std::all_of(bins.begin(),
+                      bins.end(),
+                      [](uint64_t c) { return c == COUNT / NBINS; }),
+          "uniform: same count in every bin");
+  }
+
+  // random values beyond [0, 1], special values, the bounds and bin edges
+  {
+    std::mt19937                          gen(1);
+    std::uniform_real_distribution<float> dis(-0.25f, 1.25f);
+
+    std::vector<float> data(COUNT);
+    for (auto &v : data)
+      v = dis(gen);
+
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    std::vector<float> special = {nan, inf, -inf, -0.f, 0.f, 1.f, -1e-7f, 1.0000001f};
+    for (int k = 0; k <= NBINS; ++k)
+      special.push_back(static_cast<float>(k) / static_cast<float>(NBINS));
+
+    // spread over the blocks
+    for (size_t k = 0; k < special.size(); ++k)
+      data[k * (COUNT / special.size())] = special[k];
+
+    std::vector<uint64_t> bins = qsx::compute_histogram(data, NBINS, no_cancel);
+    std::vector<uint64_t> expected = serial_histogram(data, NBINS);
+
+    uint64_t in_range = 0;
+    for (float v : data)
+      in_range += v >= 0.f && v <= 1.f;
+
+    uint64_t total = 0;
+    for (uint64_t c : bins)
+      total += c;
+
+    check(bins == expected, "random: parallel vs serial count");
+    check(total == in_range, "random: values outside of [0, 1] and NaN not counted");
+    check(total < COUNT, "random: some values out of range");
+  }
+
+  // single bin, partial last block
+  {
+    std::vector<float>    data = {0.f, 0.5f, 1.f, 2.f, -1.f};
+    std::vector<uint64_t> bins = qsx::compute_histogram(data, 1, no_cancel);
+
+    check(bins == std::vector<uint64_t>{3}, "single bin");
+  }
+
+  // empty span
+  {
+    std::vector<uint64_t> bins = qsx::compute_histogram({}, NBINS, no_cancel);
+
+    check(bins.size() == NBINS, "empty: bin count");
+    check(std::all_of(bins.begin(), bins.end(), [](uint64_t c) { return c == 0; }),
+          "empty: no count");
+  }
+
+  // canceled
+  {
+    const std::atomic<bool> cancel = true;
+    std::vector<float>      data(COUNT, 0.5f);
+
+    check(qsx::compute_histogram(data, NBINS, cancel).empty(),
+          "canceled: empty histogram");
+  }
+
+  std::cout << (failures ? "FAILED, " + std::to_string(failures) + " check(s)" : "OK")
+            << "\n";
+
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -86,6 +86,12 @@ int main(int argc, char *argv[])
       std::vector<float> y = {0.5f, 0.5f, 0.6f};
       s->set_points(x, y);
       s->set_connected_points(true);
+
+      // no copy views of the points
+      qsx::Logger::log()->trace("points: {} {} {}",
+                                s->get_points_x_span().size(),
+                                s->get_points_y_span().size(),
+                                s->get_points_z_span().size());
       s->set_draw_z_value(true);
       s->set_bg_image(QImage("bg.png"));
 